@@ -0,0 +1,751 @@
+#pragma once
+
+#include "function.hpp"
+
+#include <array>
+#include <chrono>
+#include <limits>
+
+namespace hpp
+{
+// Memoization
+
+    // Bounded LRU map from argument tuples to results. Entries live in a fixed slab linked in recency order and
+    // are found through an open addressing index table with linear probing and backward shift deletion
+    template<typename Key, typename Value, std::size_t Capacity>
+    class _memo_cache
+    {
+        static_assert( Capacity > 0 && Capacity < std::numeric_limits<std::uint32_t>::max() / 2, "Memoization capacity out of range" );
+
+        static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+
+        static constexpr auto table_size() -> std::size_t
+        {
+            std::size_t size = 1;
+            while( size < Capacity * 2 )
+            {
+                size *= 2;
+            }
+            return size;
+        }
+
+        static constexpr std::size_t mask = table_size() - 1;
+
+        struct _entry_t
+        {
+            Key key;
+            Value value;
+            std::size_t hash;
+            std::uint32_t newer;
+            std::uint32_t older;
+        };
+
+        auto home( std::size_t hash ) const -> std::size_t
+        {
+            return hash & mask;
+        }
+
+        // Index table position of the entry with the given key, or of the empty position ending its probe sequence
+        auto probe( const Key& key, std::size_t hash ) const -> std::size_t
+        {
+            auto position = home( hash );
+            while( index_[position] != none )
+            {
+                const auto& entry = *slab_[index_[position]];
+                if( entry.hash == hash && entry.key == key )
+                {
+                    break;
+                }
+                position = ( position + 1 ) & mask;
+            }
+            return position;
+        }
+
+        void unlink( std::uint32_t slot )
+        {
+            auto& entry = *slab_[slot];
+            ( entry.newer != none ? slab_[entry.newer]->older : newest_ ) = entry.older;
+            ( entry.older != none ? slab_[entry.older]->newer : oldest_ ) = entry.newer;
+        }
+
+        void link_newest( std::uint32_t slot )
+        {
+            auto& entry = *slab_[slot];
+            entry.newer = none;
+            entry.older = newest_;
+            ( newest_ != none ? slab_[newest_]->newer : oldest_ ) = slot;
+            newest_ = slot;
+        }
+
+        // Removes the index table position, shifting back the entries of its probe sequence
+        void erase_position( std::size_t hole )
+        {
+            for( auto position = ( hole + 1 ) & mask; index_[position] != none; position = ( position + 1 ) & mask )
+            {
+                const auto distance = ( position - home(slab_[index_[position]]->hash) ) & mask;
+                if( distance >= ( ( position - hole ) & mask ) )
+                {
+                    index_[hole] = index_[position];
+                    hole = position;
+                }
+            }
+            index_[hole] = none;
+        }
+
+        std::vector<optional<_entry_t>> slab_ = std::vector<optional<_entry_t>>( Capacity );
+        std::vector<std::uint32_t> index_ = std::vector<std::uint32_t>( table_size(), none );
+        std::uint32_t newest_ = none;
+        std::uint32_t oldest_ = none;
+        std::uint32_t size_ = 0;
+
+    public:
+
+        // Returns the cached value and marks it as most recently used, or nullptr
+        auto find( const Key& key, std::size_t hash ) -> const Value*
+        {
+            const auto position = probe( key, hash );
+            if( index_[position] == none )
+            {
+                return nullptr;
+            }
+
+            const auto slot = index_[position];
+            if( slot != newest_ )
+            {
+                unlink( slot );
+                link_newest( slot );
+            }
+            return &slab_[slot]->value;
+        }
+
+        // Inserts or replaces the value, evicting the least recently used entry when full
+        void insert( Key key, std::size_t hash, Value value )
+        {
+            auto position = probe( key, hash );
+            if( index_[position] != none )
+            {
+                const auto slot = index_[position];
+                slab_[slot]->value = std::move( value );
+                unlink( slot );
+                link_newest( slot );
+                return;
+            }
+
+            std::uint32_t slot = size_;
+            if( size_ == Capacity )
+            {
+                slot = oldest_;
+                unlink( slot );
+                erase_position( probe(slab_[slot]->key, slab_[slot]->hash) );
+                position = probe( key, hash );
+            }
+            else
+            {
+                ++size_;
+            }
+
+            slab_[slot].emplace( _entry_t{ std::move(key), std::move(value), hash, none, none } );
+            index_[position] = slot;
+            link_newest( slot );
+        }
+
+        void clear()
+        {
+            if( size_ == 0 )
+            {
+                return;
+            }
+
+            for( auto& entry : slab_ )
+            {
+                entry.reset();
+            }
+            std::fill( index_.begin(), index_.end(), none );
+            newest_ = none;
+            oldest_ = none;
+            size_ = 0;
+        }
+
+        auto size() const -> std::size_t
+        {
+            return size_;
+        }
+    };
+
+    template<typename... Args>
+    struct _memo_key
+    {
+        using type = std::tuple<typename std::decay<Args>::type...>;
+
+        template<std::size_t... Is>
+        static auto hash( const type& key, std::index_sequence<Is...> /*seq*/ ) -> std::size_t
+        {
+            std::size_t seed = 0;
+            (void)std::initializer_list<int>{ ( seed ^= std::hash<typename std::tuple_element<Is, type>::type>{}( std::get<Is>(key) ) + 0x9e3779b97f4a7c15ull + ( seed << 6 ) + ( seed >> 2 ), 0 )... };
+            return seed;
+        }
+
+        static auto hash( const type& key ) -> std::size_t
+        {
+            return hash( key, std::index_sequence_for<Args...>{} );
+        }
+    };
+
+    // Keeps forwarding constructors from hiding the copy and move constructors
+    template<typename Self, typename... Args>
+    struct _is_self : std::false_type {};
+
+    template<typename Self, typename Arg>
+    struct _is_self<Self, Arg> : std::is_same<Self, typename std::decay<Arg>::type> {};
+
+    template<typename FunctionSignature, std::size_t Capacity = 64, typename Storage = default_storage, typename Policy = default_policy>
+    class memoized;
+
+    // Caches the results of a pure value function by argument, keeping the most recently used ones. Calls that
+    // produce no value are not cached. The cache is flushed when the function is reconnected, assigned or
+    // disconnected, and when its sentinel is found expired. Not thread-safe, see concurrent_memoized
+    template<typename ReturnType, typename... Args, std::size_t Capacity, typename Storage, typename Policy>
+    class memoized<ReturnType(Args...), Capacity, Storage, Policy>
+    {
+        static_assert( !is_void<ReturnType>::value && !std::is_reference<ReturnType>::value, "Function: Memoized functions must return values" );
+
+        using key_t = typename _memo_key<Args...>::type;
+
+    public:
+
+        using function_t = function<ReturnType(Args...), Storage, Policy>;
+        using return_t = typename function_t::return_t;
+
+    private:
+
+        function_t function_ {};
+        mutable _memo_cache<key_t, ReturnType, Capacity> cache_ {};
+
+    public:
+
+        memoized() = default;
+
+        // Accepts every argument combination accepted by the function constructors
+        template<typename... FunctionArgs, typename = typename std::enable_if<!_is_self<memoized, FunctionArgs...>::value>::type>
+        explicit memoized( FunctionArgs&&... args )
+            : function_( std::forward<FunctionArgs>(args)... )
+        {}
+
+    // Connection
+
+        template<typename... ConnectArgs>
+        void connect( ConnectArgs&&... args )
+        {
+            function_.connect( std::forward<ConnectArgs>(args)... );
+            cache_.clear();
+        }
+
+        template<auto Method, class Class>
+        void connect( const sentinel_opt_t& sentinel,
+                      Class* const object_ptr )
+        {
+            function_.template connect<Method>( sentinel, object_ptr );
+            cache_.clear();
+        }
+
+        template<auto Method, class Class>
+        void connect( Class* const object_ptr )
+        {
+            function_.template connect<Method>( object_ptr );
+            cache_.clear();
+        }
+
+        template<typename Function, typename = _function_enabler<memoized, Function>>
+        auto operator=( Function&& f ) -> memoized&
+        {
+            function_ = std::forward<Function>( f );
+            cache_.clear();
+            return *this;
+        }
+
+        void disconnect()
+        {
+            function_.disconnect();
+            cache_.clear();
+        }
+
+    // Utilities
+
+        auto empty() const -> bool
+        {
+            return function_.empty();
+        }
+
+        auto expired() const -> bool
+        {
+            return function_.expired();
+        }
+
+        auto valid() const -> bool
+        {
+            return function_.valid();
+        }
+
+        operator bool() const
+        {
+            return valid();
+        }
+
+        // Number of cached results
+        auto size() const -> std::size_t
+        {
+            return cache_.size();
+        }
+
+        void flush()
+        {
+            cache_.clear();
+        }
+
+    // Call
+
+        template<typename... FunctionArgs>
+        auto operator()( FunctionArgs&&... args ) const -> return_t
+        {
+            if( function_.expired() )
+            {
+                cache_.clear();
+                return no_value;
+            }
+
+            key_t key( std::forward<FunctionArgs>(args)... );
+            const auto hash = _memo_key<Args...>::hash( key );
+
+            if( const auto* cached = cache_.find(key, hash) )
+            {
+                return return_t{ *cached };
+            }
+
+            auto result = std::apply( function_, static_cast<const key_t&>(key) );
+            if( result != no_value )
+            {
+                cache_.insert( std::move(key), hash, *result );
+            }
+            return result;
+        }
+    };
+
+    template<typename FunctionSignature, std::size_t Shards = 16, std::size_t Capacity = 64, typename Storage = default_storage, typename Policy = default_policy>
+    class concurrent_memoized;
+
+    // Thread-safe memoized function for many concurrent readers. Arguments are hashed to one of Shards independently
+    // locked caches of Capacity entries each; the function runs outside of any lock, so concurrent misses on the same
+    // arguments may both call it. Connecting, assigning and disconnecting must not run concurrently with calls
+    template<typename ReturnType, typename... Args, std::size_t Shards, std::size_t Capacity, typename Storage, typename Policy>
+    class concurrent_memoized<ReturnType(Args...), Shards, Capacity, Storage, Policy>
+    {
+        static_assert( !is_void<ReturnType>::value && !std::is_reference<ReturnType>::value, "Function: Memoized functions must return values" );
+        static_assert( Shards > 0, "Memoization needs at least one shard" );
+
+        using key_t = typename _memo_key<Args...>::type;
+
+        struct alignas(64) _shard_t
+        {
+            std::mutex mutex;
+            _memo_cache<key_t, ReturnType, Capacity> cache;
+        };
+
+    public:
+
+        using function_t = function<ReturnType(Args...), Storage, Policy>;
+        using return_t = typename function_t::return_t;
+
+    private:
+
+        function_t function_ {};
+        mutable std::array<_shard_t, Shards> shards_ {};
+
+        // Bumped on every flush, so that results computed before it are not inserted after it
+        mutable std::atomic<std::uint64_t> generation_ { 0 };
+
+    public:
+
+        concurrent_memoized() = default;
+
+        // Accepts every argument combination accepted by the function constructors
+        template<typename... FunctionArgs, typename = typename std::enable_if<!_is_self<concurrent_memoized, FunctionArgs...>::value>::type>
+        explicit concurrent_memoized( FunctionArgs&&... args )
+            : function_( std::forward<FunctionArgs>(args)... )
+        {}
+
+    // Connection
+
+        template<typename... ConnectArgs>
+        void connect( ConnectArgs&&... args )
+        {
+            function_.connect( std::forward<ConnectArgs>(args)... );
+            flush();
+        }
+
+        template<auto Method, class Class>
+        void connect( const sentinel_opt_t& sentinel,
+                      Class* const object_ptr )
+        {
+            function_.template connect<Method>( sentinel, object_ptr );
+            flush();
+        }
+
+        template<auto Method, class Class>
+        void connect( Class* const object_ptr )
+        {
+            function_.template connect<Method>( object_ptr );
+            flush();
+        }
+
+        template<typename Function, typename = _function_enabler<concurrent_memoized, Function>>
+        auto operator=( Function&& f ) -> concurrent_memoized&
+        {
+            function_ = std::forward<Function>( f );
+            flush();
+            return *this;
+        }
+
+        void disconnect()
+        {
+            function_.disconnect();
+            flush();
+        }
+
+    // Utilities
+
+        auto empty() const -> bool
+        {
+            return function_.empty();
+        }
+
+        auto expired() const -> bool
+        {
+            return function_.expired();
+        }
+
+        auto valid() const -> bool
+        {
+            return function_.valid();
+        }
+
+        operator bool() const
+        {
+            return valid();
+        }
+
+        // Number of cached results
+        auto size() const -> std::size_t
+        {
+            std::size_t count = 0;
+            for( auto& shard : shards_ )
+            {
+                std::lock_guard<std::mutex> lock( shard.mutex );
+                count += shard.cache.size();
+            }
+            return count;
+        }
+
+        void flush() const
+        {
+            generation_.fetch_add( 1, std::memory_order_acq_rel );
+            for( auto& shard : shards_ )
+            {
+                std::lock_guard<std::mutex> lock( shard.mutex );
+                shard.cache.clear();
+            }
+        }
+
+    // Call
+
+        template<typename... FunctionArgs>
+        auto operator()( FunctionArgs&&... args ) const -> return_t
+        {
+            if( function_.expired() )
+            {
+                flush();
+                return no_value;
+            }
+
+            key_t key( std::forward<FunctionArgs>(args)... );
+            const auto hash = _memo_key<Args...>::hash( key );
+            auto& shard = shards_[( hash >> 7 ) % Shards];
+            const auto generation = generation_.load( std::memory_order_acquire );
+
+            {
+                std::lock_guard<std::mutex> lock( shard.mutex );
+                if( const auto* cached = shard.cache.find(key, hash) )
+                {
+                    return return_t{ *cached };
+                }
+            }
+
+            auto result = std::apply( function_, static_cast<const key_t&>(key) );
+            if( result != no_value )
+            {
+                std::lock_guard<std::mutex> lock( shard.mutex );
+                if( generation_.load(std::memory_order_acquire) == generation )
+                {
+                    shard.cache.insert( std::move(key), hash, *result );
+                }
+            }
+            return result;
+        }
+    };
+
+// Rate limiting
+
+    template<typename FunctionSignature, typename Storage, typename Policy>
+    class _pending_call;
+
+    // Void function with room for one pending call. The latest arguments are kept in place, so deferring a call
+    // never allocates; firing goes through the function, so sentinel and function_exception semantics apply
+    template<typename... Args, typename Storage, typename Policy>
+    class _pending_call<void(Args...), Storage, Policy>
+    {
+    public:
+
+        using function_t = function<void(Args...), Storage, Policy>;
+
+    protected:
+
+        using arguments_t = std::tuple<typename std::decay<Args>::type...>;
+
+        _pending_call() = default;
+
+        template<typename... FunctionArgs>
+        explicit _pending_call( FunctionArgs&&... args )
+            : function_( std::forward<FunctionArgs>(args)... )
+        {}
+
+        template<typename... CallArgs>
+        void defer( CallArgs&&... args )
+        {
+            pending_.emplace( std::forward<CallArgs>(args)... );
+        }
+
+        // The pending arguments are released before the call, so the callee may defer a new call
+        void fire()
+        {
+            auto arguments = std::move( *pending_ );
+            pending_.reset();
+            std::apply( function_, std::move(arguments) );
+        }
+
+        function_t function_ {};
+        optional<arguments_t> pending_ {};
+
+    public:
+
+    // Connection
+
+        // Reconnecting drops the pending call
+        template<typename... ConnectArgs>
+        void connect( ConnectArgs&&... args )
+        {
+            function_.connect( std::forward<ConnectArgs>(args)... );
+            pending_.reset();
+        }
+
+        template<auto Method, class Class>
+        void connect( const sentinel_opt_t& sentinel,
+                      Class* const object_ptr )
+        {
+            function_.template connect<Method>( sentinel, object_ptr );
+            pending_.reset();
+        }
+
+        template<auto Method, class Class>
+        void connect( Class* const object_ptr )
+        {
+            function_.template connect<Method>( object_ptr );
+            pending_.reset();
+        }
+
+        void disconnect()
+        {
+            function_.disconnect();
+            pending_.reset();
+        }
+
+    // Utilities
+
+        auto empty() const -> bool
+        {
+            return function_.empty();
+        }
+
+        auto expired() const -> bool
+        {
+            return function_.expired();
+        }
+
+        auto valid() const -> bool
+        {
+            return function_.valid();
+        }
+
+        operator bool() const
+        {
+            return valid();
+        }
+
+        auto pending() const -> bool
+        {
+            return pending_ != no_value;
+        }
+
+        void cancel()
+        {
+            pending_.reset();
+        }
+
+        // Fires the pending call right away, returns whether there was one
+        auto flush() -> bool
+        {
+            if( pending_ == no_value )
+            {
+                return false;
+            }
+
+            fire();
+            return true;
+        }
+    };
+
+    template<typename FunctionSignature, typename Clock = std::chrono::steady_clock, typename Storage = default_storage, typename Policy = default_policy>
+    class throttled;
+
+    // Calls through at most once per interval. The first call of an interval runs immediately, later ones replace
+    // a single pending call that poll() fires once the interval has elapsed
+    template<typename... Args, typename Clock, typename Storage, typename Policy>
+    class throttled<void(Args...), Clock, Storage, Policy>
+        : public _pending_call<void(Args...), Storage, Policy>
+    {
+        using base_t = _pending_call<void(Args...), Storage, Policy>;
+
+        typename Clock::duration interval_;
+        optional<typename Clock::time_point> last_ {};
+
+        auto elapsed( typename Clock::time_point now ) const -> bool
+        {
+            return last_ == no_value || now - *last_ >= interval_;
+        }
+
+    public:
+
+        // The remaining arguments are forwarded to the function constructor
+        template<typename... FunctionArgs>
+        explicit throttled( typename Clock::duration interval,
+                            FunctionArgs&&... args )
+            : base_t( std::forward<FunctionArgs>(args)... ),
+              interval_( interval )
+        {}
+
+        template<typename... CallArgs>
+        void operator()( CallArgs&&... args )
+        {
+            const auto now = Clock::now();
+            if( elapsed(now) )
+            {
+                last_ = now;
+                this->pending_.reset();
+                this->function_( std::forward<CallArgs>(args)... );
+            }
+            else
+            {
+                this->defer( std::forward<CallArgs>(args)... );
+            }
+        }
+
+        // Fires the pending call if the interval has elapsed, returns whether it did
+        auto poll( typename Clock::time_point now = Clock::now() ) -> bool
+        {
+            if( this->pending_ == no_value || !elapsed(now) )
+            {
+                return false;
+            }
+
+            last_ = now;
+            this->fire();
+            return true;
+        }
+    };
+
+    template<typename FunctionSignature, typename Clock = std::chrono::steady_clock, typename Storage = default_storage, typename Policy = default_policy>
+    class debounced;
+
+    // Calls through once calls have stopped for the given delay, with the arguments of the last call.
+    // Every call restarts the delay; poll() fires the pending call once it has passed
+    template<typename... Args, typename Clock, typename Storage, typename Policy>
+    class debounced<void(Args...), Clock, Storage, Policy>
+        : public _pending_call<void(Args...), Storage, Policy>
+    {
+        using base_t = _pending_call<void(Args...), Storage, Policy>;
+
+        typename Clock::duration delay_;
+        typename Clock::time_point deadline_ {};
+
+    public:
+
+        // The remaining arguments are forwarded to the function constructor
+        template<typename... FunctionArgs>
+        explicit debounced( typename Clock::duration delay,
+                            FunctionArgs&&... args )
+            : base_t( std::forward<FunctionArgs>(args)... ),
+              delay_( delay )
+        {}
+
+        template<typename... CallArgs>
+        void operator()( CallArgs&&... args )
+        {
+            deadline_ = Clock::now() + delay_;
+            this->defer( std::forward<CallArgs>(args)... );
+        }
+
+        // Fires the pending call if the delay has passed, returns whether it did
+        auto poll( typename Clock::time_point now = Clock::now() ) -> bool
+        {
+            if( this->pending_ == no_value || now < deadline_ )
+            {
+                return false;
+            }
+
+            this->fire();
+            return true;
+        }
+    };
+
+    template<typename FunctionSignature, typename Storage = default_storage, typename Policy = default_policy>
+    class coalescing;
+
+    // Keeps the arguments of the last call and calls through once per tick(), e.g. once per frame
+    template<typename... Args, typename Storage, typename Policy>
+    class coalescing<void(Args...), Storage, Policy>
+        : public _pending_call<void(Args...), Storage, Policy>
+    {
+        using base_t = _pending_call<void(Args...), Storage, Policy>;
+
+    public:
+
+        coalescing() = default;
+
+        // Accepts every argument combination accepted by the function constructors
+        template<typename... FunctionArgs, typename = typename std::enable_if<!_is_self<coalescing, FunctionArgs...>::value>::type>
+        explicit coalescing( FunctionArgs&&... args )
+            : base_t( std::forward<FunctionArgs>(args)... )
+        {}
+
+        template<typename... CallArgs>
+        void operator()( CallArgs&&... args )
+        {
+            this->defer( std::forward<CallArgs>(args)... );
+        }
+
+        // Fires the pending call, returns whether there was one
+        auto tick() -> bool
+        {
+            return this->flush();
+        }
+    };
+
+} // namespace hpp
@@ -0,0 +1,622 @@
+#pragma once
+
+#include "function.hpp"
+
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#error "Function: async_function.hpp requires C++20 coroutine support"
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hpp
+{
+// Coroutine task
+
+    template<typename T>
+    class task;
+
+    template<typename T>
+    class _cancellable_await;
+
+    template<typename T>
+    struct _task_promise_base
+    {
+        using completion_t = std::coroutine_handle<>(*)( void* ) noexcept;
+
+        // Resumes the awaiting coroutine once the task completes, or hands over to the completion callback
+        // of a cancellable await, which decides who runs next
+        struct _final_awaiter
+        {
+            auto await_ready() const noexcept -> bool
+            {
+                return false;
+            }
+
+            template<typename Promise>
+            auto await_suspend( std::coroutine_handle<Promise> handle ) const noexcept -> std::coroutine_handle<>
+            {
+                auto& promise = handle.promise();
+                if( promise.completion != nullptr )
+                {
+                    return promise.completion( promise.completion_context );
+                }
+
+                const auto continuation = promise.continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept
+            {}
+        };
+
+        auto initial_suspend() const noexcept -> std::suspend_always
+        {
+            return {};
+        }
+
+        auto final_suspend() const noexcept -> _final_awaiter
+        {
+            return {};
+        }
+
+        void unhandled_exception() noexcept
+        {
+            exception = std::current_exception();
+        }
+
+        void rethrow_if_failed() const
+        {
+            if( exception )
+            {
+                std::rethrow_exception( exception );
+            }
+        }
+
+        std::coroutine_handle<> continuation {};
+        completion_t completion = nullptr;
+        void* completion_context = nullptr;
+        std::exception_ptr exception {};
+    };
+
+    template<typename T>
+    struct _task_promise
+        : _task_promise_base<T>
+    {
+        auto get_return_object() -> task<T>;
+
+        template<typename Value>
+        void return_value( Value&& value )
+        {
+            result.emplace( std::forward<Value>(value) );
+        }
+
+        auto take() -> T
+        {
+            this->rethrow_if_failed();
+            return std::move( *result );
+        }
+
+        optional<T> result {};
+    };
+
+    template<>
+    struct _task_promise<void>
+        : _task_promise_base<void>
+    {
+        auto get_return_object() -> task<void>;
+
+        void return_void() const noexcept
+        {}
+
+        void take() const
+        {
+            rethrow_if_failed();
+        }
+    };
+
+    // Lazily started, single await coroutine result with symmetric transfer to the awaiting coroutine
+    template<typename T>
+    class task
+    {
+    public:
+
+        using promise_type = _task_promise<T>;
+        using handle_t = std::coroutine_handle<promise_type>;
+
+        task() = default;
+
+        explicit task( handle_t handle ) noexcept
+            : handle_( handle )
+        {}
+
+        task( task&& other ) noexcept
+            : handle_( std::exchange(other.handle_, nullptr) )
+        {}
+
+        auto operator=( task&& other ) noexcept -> task&
+        {
+            if( this != &other )
+            {
+                reset();
+                handle_ = std::exchange( other.handle_, nullptr );
+            }
+            return *this;
+        }
+
+        ~task()
+        {
+            reset();
+        }
+
+        auto await_ready() const noexcept -> bool
+        {
+            return !handle_ || handle_.done();
+        }
+
+        auto await_suspend( std::coroutine_handle<> awaiting ) noexcept -> std::coroutine_handle<>
+        {
+            handle_.promise().continuation = awaiting;
+            return handle_;
+        }
+
+        auto await_resume() -> T
+        {
+            return handle_.promise().take();
+        }
+
+        // Runs the task to its first suspension point without awaiting it, e.g. from non-coroutine code
+        void start()
+        {
+            if( !await_ready() )
+            {
+                handle_.resume();
+            }
+        }
+
+        auto done() const noexcept -> bool
+        {
+            return handle_ && handle_.done();
+        }
+
+        auto get() -> T
+        {
+            return handle_.promise().take();
+        }
+
+    private:
+
+        template<typename>
+        friend class _cancellable_await;
+
+        void reset() noexcept
+        {
+            if( handle_ )
+            {
+                handle_.destroy();
+                handle_ = nullptr;
+            }
+        }
+
+        handle_t handle_ {};
+    };
+
+    template<typename T>
+    auto _task_promise<T>::get_return_object() -> task<T>
+    {
+        return task<T>( std::coroutine_handle<_task_promise>::from_promise(*this) );
+    }
+
+    inline auto _task_promise<void>::get_return_object() -> task<void>
+    {
+        return task<void>( std::coroutine_handle<_task_promise>::from_promise(*this) );
+    }
+
+    // Suspended awaits of an async_function that cancel() resumes early. Shared with the awaits themselves,
+    // so that an await completing after the async_function was destroyed can still unregister
+    class _async_waiters
+    {
+    public:
+
+        struct wait_t
+        {
+            static constexpr int pending = 0;
+            static constexpr int completed = 1;
+            static constexpr int cancelled = 2;
+
+            std::atomic<int> state { pending };
+            std::coroutine_handle<> awaiting {};
+            std::coroutine_handle<> callee {};
+
+            // Keeps the wait alive for a callee that outlives its cancelled await
+            std::shared_ptr<wait_t> self {};
+        };
+
+        void add( const std::shared_ptr<wait_t>& wait )
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            waits_.push_back( wait );
+        }
+
+        void remove( const wait_t* wait )
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            waits_.erase( std::remove_if(waits_.begin(), waits_.end(), [wait]( const auto& w ){ return w.get() == wait; }), waits_.end() );
+        }
+
+        // Resumes every await still waiting for its callee and returns how many there were
+        auto cancel() -> std::size_t
+        {
+            std::vector<std::shared_ptr<wait_t>> cancelled;
+
+            {
+                std::lock_guard<std::mutex> lock( mutex_ );
+                for( const auto& wait : waits_ )
+                {
+                    auto expected = wait_t::pending;
+                    if( wait->state.compare_exchange_strong(expected, wait_t::cancelled, std::memory_order_acq_rel) )
+                    {
+                        cancelled.push_back( wait );
+                    }
+                }
+            }
+
+            for( const auto& wait : cancelled )
+            {
+                wait->awaiting.resume();
+            }
+
+            return cancelled.size();
+        }
+
+    private:
+
+        std::mutex mutex_;
+        std::vector<std::shared_ptr<wait_t>> waits_;
+    };
+
+    // Awaits a task unless cancelled first. A cancelled await resumes at once without a result; its callee is
+    // left suspended rather than destroyed, since whatever it waits on may still resume it, and it frees itself
+    // if it ever completes
+    template<typename T>
+    class _cancellable_await
+    {
+        using wait_t = _async_waiters::wait_t;
+        using handle_t = typename task<T>::handle_t;
+
+        std::shared_ptr<_async_waiters> waiters_;
+        std::shared_ptr<wait_t> wait_ = std::make_shared<wait_t>();
+        handle_t callee_;
+
+        static auto complete( void* context ) noexcept -> std::coroutine_handle<>
+        {
+            auto* wait = static_cast<wait_t*>( context );
+            auto expected = wait_t::pending;
+
+            if( wait->state.compare_exchange_strong(expected, wait_t::completed, std::memory_order_acq_rel) )
+            {
+                return wait->awaiting;
+            }
+
+            // The await was cancelled and is gone, the callee frame and the wait are not needed anymore
+            wait->callee.destroy();
+            auto self = std::move( wait->self );
+            return std::noop_coroutine();
+        }
+
+    public:
+
+        _cancellable_await( std::shared_ptr<_async_waiters> waiters,
+                            task<T>&& callee )
+            : waiters_( std::move(waiters) ),
+              callee_( std::exchange(callee.handle_, nullptr) )
+        {}
+
+        _cancellable_await( const _cancellable_await& ) = delete;
+        auto operator=( const _cancellable_await& ) -> _cancellable_await& = delete;
+
+        // Destroyed while still suspended, because the awaiting frame was destroyed, the await cancels itself
+        ~_cancellable_await()
+        {
+            if( !callee_ )
+            {
+                return;
+            }
+
+            auto state = wait_t::pending;
+            if( wait_->self != nullptr && wait_->state.compare_exchange_strong(state, wait_t::cancelled, std::memory_order_acq_rel) )
+            {
+                waiters_->remove( wait_.get() );
+                return;
+            }
+
+            if( state != wait_t::cancelled )
+            {
+                callee_.destroy();
+            }
+        }
+
+        auto await_ready() const noexcept -> bool
+        {
+            return !callee_ || callee_.done();
+        }
+
+        auto await_suspend( std::coroutine_handle<> awaiting ) -> std::coroutine_handle<>
+        {
+            wait_->awaiting = awaiting;
+            wait_->callee = callee_;
+            wait_->self = wait_;
+            callee_.promise().completion = &complete;
+            callee_.promise().completion_context = wait_.get();
+            waiters_->add( wait_ );
+            return callee_;
+        }
+
+        // Whether the callee completed; its result is then taken with take()
+        auto await_resume() -> bool
+        {
+            if( wait_->self != nullptr )
+            {
+                waiters_->remove( wait_.get() );
+            }
+
+            if( wait_->state.load(std::memory_order_acquire) == wait_t::cancelled )
+            {
+                return false;
+            }
+
+            wait_->self.reset();
+            return true;
+        }
+
+        auto take() -> T
+        {
+            return callee_.promise().take();
+        }
+    };
+
+    template<typename T>
+    struct _is_task : std::false_type {};
+
+    template<typename T>
+    struct _is_task<task<T>> : std::true_type {};
+
+// Asynchronous function
+
+    template<typename FunctionSignature, typename Storage = default_storage, typename Policy = default_policy>
+    class async_function;
+
+    // Function whose call is awaited. The callee is either a coroutine returning task<ReturnType> or a plain
+    // callable returning ReturnType. Awaiting the call yields optional<ReturnType>, which holds no value when
+    // the function is empty, its sentinel expired before the call or before the callee completed, or the callee
+    // threw a non-passthrough function_exception; void functions yield whether the call completed.
+    // Calls waiting on a suspended callee also yield no value once cancel() is called, e.g. by the sentinel owner's
+    // destructor when the callee waits on something the owner will never complete. Destroying the async_function
+    // cancels its waiting calls, otherwise it must outlive the awaited calls
+    template<typename Storage, typename Policy, typename ReturnType, typename... Args>
+    class async_function<ReturnType(Args...), Storage, Policy>
+    {
+        using async_t = function<task<ReturnType>(Args...), Storage, Policy>;
+        using sync_t = function<ReturnType(Args...), Storage, Policy>;
+
+        async_t async_ {};
+        sync_t sync_ {};
+        std::shared_ptr<_async_waiters> waiters_ = std::make_shared<_async_waiters>();
+
+        template<typename Function>
+        void connect_callable( const sentinel_opt_t& sentinel,
+                               Function&& f )
+        {
+            using result_t = typename std::invoke_result<typename std::decay<Function>::type&, Args...>::type;
+
+            if constexpr( _is_task<result_t>::value )
+            {
+                sync_.disconnect();
+                async_.connect( sentinel, std::forward<Function>(f) );
+            }
+            else
+            {
+                async_.disconnect();
+                sync_.connect( sentinel, std::forward<Function>(f) );
+            }
+        }
+
+    public:
+
+        using return_t = typename std::conditional<is_void<ReturnType>::value, bool, optional<ReturnType>>::type;
+
+    // Utilities
+
+        void disconnect() const
+        {
+            async_.disconnect();
+            sync_.disconnect();
+        }
+
+        // Resumes the calls waiting on a suspended callee without a value and returns how many there were.
+        // Their callees stay suspended and are freed if they complete later
+        auto cancel() const -> std::size_t
+        {
+            return waiters_ != nullptr ? waiters_->cancel() : 0;
+        }
+
+        auto empty() const -> bool
+        {
+            return async_.empty() && sync_.empty();
+        }
+
+        auto expired() const -> bool
+        {
+            return async_.empty() ? sync_.expired() : async_.expired();
+        }
+
+        auto valid() const -> bool
+        {
+            return async_.valid() || sync_.valid();
+        }
+
+        operator bool() const
+        {
+            return valid();
+        }
+
+    // Connection
+
+        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<async_function, Function, Sentinel>>
+        void connect( const Sentinel& sentinel,
+                      Function&& f )
+        {
+            connect_callable( sentinel, std::forward<Function>(f) );
+        }
+
+        template<class Class, typename Method, typename = typename std::enable_if<std::is_member_function_pointer<Method>::value>::type>
+        void connect( const sentinel_opt_t& sentinel,
+                      Class* const object_ptr,
+                      Method method_ptr )
+        {
+            connect_callable( sentinel, [object_ptr, method_ptr](auto&&... args){ return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
+        }
+
+        template<class Class, typename Method, typename = typename std::enable_if<std::is_member_function_pointer<Method>::value>::type>
+        void connect( Class* const object_ptr,
+                      Method method_ptr )
+        {
+            connect( no_value, object_ptr, method_ptr );
+        }
+
+        template<typename Function, typename = _function_enabler<async_function, Function>>
+        void connect( Function&& f )
+        {
+            connect( no_value, std::forward<Function>(f) );
+        }
+
+        async_function() = default;
+
+        // Copies do not share waiting calls
+        async_function( const async_function& other )
+            : async_( other.async_ ),
+              sync_( other.sync_ )
+        {}
+
+        async_function( async_function&& other ) noexcept
+            : async_( std::move(other.async_) ),
+              sync_( std::move(other.sync_) ),
+              waiters_( std::move(other.waiters_) )
+        {}
+
+        auto operator=( const async_function& other ) -> async_function&
+        {
+            async_ = other.async_;
+            sync_ = other.sync_;
+            return *this;
+        }
+
+        auto operator=( async_function&& other ) noexcept -> async_function&
+        {
+            if( this != &other )
+            {
+                cancel();
+                async_ = std::move( other.async_ );
+                sync_ = std::move( other.sync_ );
+                waiters_ = std::move( other.waiters_ );
+            }
+            return *this;
+        }
+
+        ~async_function()
+        {
+            cancel();
+        }
+
+        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<async_function, Function, Sentinel>>
+        async_function( const Sentinel& sentinel,
+                        Function&& f )
+        {
+            connect( sentinel, std::forward<Function>(f) );
+        }
+
+        template<class Class, typename Method, typename = typename std::enable_if<std::is_member_function_pointer<Method>::value>::type>
+        async_function( const sentinel_opt_t& sentinel,
+                        Class* const object_ptr,
+                        Method method_ptr )
+        {
+            connect( sentinel, object_ptr, method_ptr );
+        }
+
+        template<class Class, typename Method, typename = typename std::enable_if<std::is_member_function_pointer<Method>::value>::type>
+        async_function( Class* const object_ptr,
+                        Method method_ptr )
+        {
+            connect( no_value, object_ptr, method_ptr );
+        }
+
+        template<typename Function, typename = _function_enabler<async_function, Function>>
+        async_function( Function&& f )
+        {
+            connect( no_value, std::forward<Function>(f) );
+        }
+
+    // Call
+
+        // Arguments are copied into the coroutine frame
+        auto operator()( Args... args ) const -> task<return_t>
+        {
+            if( !async_.valid() )
+            {
+                if constexpr( is_void<ReturnType>::value )
+                {
+                    const bool called = sync_.try_call( std::move(args)... );
+                    co_return called && !sync_.expired();
+                }
+                else
+                {
+                    co_return sync_( std::move(args)... );
+                }
+            }
+
+            auto callee = async_( std::move(args)... );
+            if( callee == no_value )
+            {
+                co_return return_t{};
+            }
+
+            try
+            {
+                _cancellable_await<ReturnType> await { waiters_, std::move(*callee) };
+                if( !co_await await )
+                {
+                    co_return return_t{};
+                }
+
+                if constexpr( is_void<ReturnType>::value )
+                {
+                    await.take();
+                    co_return !async_.expired();
+                }
+                else
+                {
+                    auto result = await.take();
+                    if( async_.expired() )
+                    {
+                        co_return return_t{};
+                    }
+
+                    co_return return_t{ std::move(result) };
+                }
+            }
+            catch( const function_exception& e )
+            {
+                if( e.is_passthrough() )
+                {
+                    throw;
+                }
+            }
+
+            co_return return_t{};
+        }
+    };
+
+} // namespace hpp
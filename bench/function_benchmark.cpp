@@ -0,0 +1,529 @@
+// Benchmarks of the hpp::function call, connect and churn paths against std::function, function_ref and direct calls.
+// Every benchmark reports allocs_per_op, the number of global operator new calls per iteration, over-aligned ones included
+
+#include "function.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#define FUNCTION_BENCHMARK_NOINLINE __declspec(noinline)
+#else
+#define FUNCTION_BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+// Allocation counting
+
+namespace
+{
+    std::atomic<std::size_t> allocations { 0 };
+
+    auto counted_allocation( std::size_t size ) -> void*
+    {
+        allocations.fetch_add( 1, std::memory_order_relaxed );
+        if( auto* memory = std::malloc(size == 0 ? 1 : size) )
+        {
+            return memory;
+        }
+
+        throw std::bad_alloc();
+    }
+
+    auto counted_allocation( std::size_t size, std::align_val_t alignment ) -> void*
+    {
+        allocations.fetch_add( 1, std::memory_order_relaxed );
+        const auto align = static_cast<std::size_t>( alignment );
+#if defined(_MSC_VER)
+        auto* memory = _aligned_malloc( size == 0 ? 1 : size, align );
+#else
+        // aligned_alloc requires the size to be a multiple of the alignment
+        auto* memory = std::aligned_alloc( align, size == 0 ? align : (size + align - 1) / align * align );
+#endif
+        if( memory != nullptr )
+        {
+            return memory;
+        }
+
+        throw std::bad_alloc();
+    }
+
+    void aligned_free( void* memory ) noexcept
+    {
+#if defined(_MSC_VER)
+        _aligned_free( memory );
+#else
+        std::free( memory );
+#endif
+    }
+
+    // Attributes the allocations made while alive to the benchmark iterations
+    class allocation_counter
+    {
+        benchmark::State& state_;
+        std::size_t start_ = allocations.load( std::memory_order_relaxed );
+
+    public:
+
+        explicit allocation_counter( benchmark::State& state )
+            : state_( state )
+        {}
+
+        ~allocation_counter()
+        {
+            const auto count = allocations.load( std::memory_order_relaxed ) - start_;
+            state_.counters["allocs_per_op"] = benchmark::Counter( static_cast<double>(count), benchmark::Counter::kAvgIterations );
+        }
+    };
+}
+
+auto operator new( std::size_t size ) -> void*
+{
+    return counted_allocation( size );
+}
+
+auto operator new[]( std::size_t size ) -> void*
+{
+    return counted_allocation( size );
+}
+
+void operator delete( void* memory ) noexcept
+{
+    std::free( memory );
+}
+
+void operator delete[]( void* memory ) noexcept
+{
+    std::free( memory );
+}
+
+void operator delete( void* memory, std::size_t /*size*/ ) noexcept
+{
+    std::free( memory );
+}
+
+void operator delete[]( void* memory, std::size_t /*size*/ ) noexcept
+{
+    std::free( memory );
+}
+
+auto operator new( std::size_t size, std::align_val_t alignment ) -> void*
+{
+    return counted_allocation( size, alignment );
+}
+
+auto operator new[]( std::size_t size, std::align_val_t alignment ) -> void*
+{
+    return counted_allocation( size, alignment );
+}
+
+void operator delete( void* memory, std::align_val_t /*alignment*/ ) noexcept
+{
+    aligned_free( memory );
+}
+
+void operator delete[]( void* memory, std::align_val_t /*alignment*/ ) noexcept
+{
+    aligned_free( memory );
+}
+
+void operator delete( void* memory, std::size_t /*size*/, std::align_val_t /*alignment*/ ) noexcept
+{
+    aligned_free( memory );
+}
+
+void operator delete[]( void* memory, std::size_t /*size*/, std::align_val_t /*alignment*/ ) noexcept
+{
+    aligned_free( memory );
+}
+
+// Callees
+
+namespace
+{
+    int global_sink = 0;
+
+    FUNCTION_BENCHMARK_NOINLINE void free_function( int value )
+    {
+        benchmark::DoNotOptimize( global_sink += value );
+    }
+
+    FUNCTION_BENCHMARK_NOINLINE auto free_value_function( int value ) -> int
+    {
+        return value + 1;
+    }
+
+    struct receiver
+    {
+        int sink = 0;
+
+        FUNCTION_BENCHMARK_NOINLINE void method( int value )
+        {
+            benchmark::DoNotOptimize( sink += value );
+        }
+
+        FUNCTION_BENCHMARK_NOINLINE auto value_method( int value ) const -> int
+        {
+            return sink + value;
+        }
+    };
+
+    struct sentinel_receiver : receiver, hpp::lifetime_sentinel {};
+
+    struct intrusive_receiver : receiver, hpp::intrusive_lifetime_sentinel {};
+
+    // Lambda capturing as much as a member function binding
+    auto make_lambda( receiver& object )
+    {
+        return [&object, offset = 1]( int value ){ object.method( value + offset ); };
+    }
+}
+
+// Baselines
+
+static void direct_call( benchmark::State& state )
+{
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( value );
+        free_function( value );
+    }
+}
+BENCHMARK( direct_call );
+
+static void std_function_call( benchmark::State& state )
+{
+    receiver object;
+    std::function<void(int)> f = make_lambda( object );
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        f( value );
+    }
+}
+BENCHMARK( std_function_call );
+
+static void function_ref_call( benchmark::State& state )
+{
+    receiver object;
+    auto lambda = make_lambda( object );
+    hpp::function_ref<void(int)> f = lambda;
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        f( value );
+    }
+}
+BENCHMARK( function_ref_call );
+
+// Call paths
+
+static void lambda_call( benchmark::State& state )
+{
+    receiver object;
+    hpp::function<void(int)> f;
+    f.connect( make_lambda(object) );
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        f( value );
+    }
+}
+BENCHMARK( lambda_call );
+
+static void nothrow_lambda_call( benchmark::State& state )
+{
+    receiver object;
+    hpp::nothrow_function<void(int)> f;
+    f.connect( make_lambda(object) );
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        f( value );
+    }
+}
+BENCHMARK( nothrow_lambda_call );
+
+static void free_function_call( benchmark::State& state )
+{
+    hpp::function<void(int)> f;
+    f.connect( &free_function );
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        f( value );
+    }
+}
+BENCHMARK( free_function_call );
+
+static void member_function_call( benchmark::State& state )
+{
+    receiver object;
+    hpp::function<void(int)> f;
+    f.connect( &object, &receiver::method );
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        f( value );
+    }
+}
+BENCHMARK( member_function_call );
+
+static void nontype_member_function_call( benchmark::State& state )
+{
+    receiver object;
+    hpp::function<void(int)> f;
+    f.connect<&receiver::method>( &object );
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        f( value );
+    }
+}
+BENCHMARK( nontype_member_function_call );
+
+static void value_call( benchmark::State& state )
+{
+    receiver object;
+    hpp::function<int(int)> f;
+    f.connect( &object, &receiver::value_method );
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        benchmark::DoNotOptimize( f(value) );
+    }
+}
+BENCHMARK( value_call );
+
+static void compact_member_function_call( benchmark::State& state )
+{
+    intrusive_receiver object;
+    hpp::compact_function<void(int)> f;
+    f.connect( object.get_sentinel(), static_cast<receiver*>(&object), &receiver::method );
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        f( value );
+    }
+}
+BENCHMARK( compact_member_function_call );
+
+// Sentinels
+
+static void lifetime_sentinel_call( benchmark::State& state )
+{
+    sentinel_receiver object;
+    hpp::function<void(int)> f;
+    f.connect( object.get_sentinel(), make_lambda(object) );
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        f( value );
+    }
+}
+BENCHMARK( lifetime_sentinel_call );
+
+static void intrusive_sentinel_call( benchmark::State& state )
+{
+    intrusive_receiver object;
+    hpp::function<void(int)> f;
+    f.connect( object.get_sentinel(), make_lambda(object) );
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        f( value );
+    }
+}
+BENCHMARK( intrusive_sentinel_call );
+
+static void expired_sentinel_call( benchmark::State& state )
+{
+    auto object = std::make_unique<sentinel_receiver>();
+    hpp::function<int(int)> f;
+    f.connect( object->get_sentinel(), &free_value_function );
+    object.reset();
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        benchmark::DoNotOptimize( f(value) );
+    }
+}
+BENCHMARK( expired_sentinel_call );
+
+static void expired_intrusive_sentinel_call( benchmark::State& state )
+{
+    auto object = std::make_unique<intrusive_receiver>();
+    hpp::function<int(int)> f;
+    f.connect( object->get_sentinel(), &free_value_function );
+    object.reset();
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        benchmark::DoNotOptimize( f(value) );
+    }
+}
+BENCHMARK( expired_intrusive_sentinel_call );
+
+// Exception translation
+
+static void function_exception_to_no_value( benchmark::State& state )
+{
+    hpp::function<int(int)> f;
+    f.connect( []( int value ) -> int
+    {
+        if( value >= 0 )
+        {
+            throw hpp::function_exception();
+        }
+        return value;
+    } );
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( f );
+        benchmark::DoNotOptimize( f(value) );
+    }
+}
+BENCHMARK( function_exception_to_no_value );
+
+// Overload sets
+
+template<std::size_t N>
+struct tag {};
+
+template<std::size_t... Is>
+using overload_set_of = hpp::overload_set<void(int), void(tag<Is>)...>;
+
+template<typename OverloadSet>
+static void overload_set_call( benchmark::State& state )
+{
+    OverloadSet overloads;
+    overloads.connect( []( auto&& value ){ benchmark::DoNotOptimize( value ); } );
+    allocation_counter counter( state );
+    int value = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( overloads );
+        overloads.call( value );
+    }
+}
+BENCHMARK_TEMPLATE( overload_set_call, overload_set_of<> );
+BENCHMARK_TEMPLATE( overload_set_call, overload_set_of<1, 2> );
+BENCHMARK_TEMPLATE( overload_set_call, overload_set_of<1, 2, 3, 4, 5, 6, 7> );
+
+// Construction and connection churn
+
+static void std_function_churn( benchmark::State& state )
+{
+    receiver object;
+    allocation_counter counter( state );
+    for( auto _ : state )
+    {
+        std::function<void(int)> f = [&object, method = &receiver::method]( int value ){ (object.*method)( value ); };
+        benchmark::DoNotOptimize( f );
+    }
+}
+BENCHMARK( std_function_churn );
+
+static void lambda_connect_churn( benchmark::State& state )
+{
+    receiver object;
+    allocation_counter counter( state );
+    for( auto _ : state )
+    {
+        hpp::function<void(int)> f;
+        f.connect( make_lambda(object) );
+        benchmark::DoNotOptimize( f );
+        f.disconnect();
+    }
+}
+BENCHMARK( lambda_connect_churn );
+
+static void member_connect_churn( benchmark::State& state )
+{
+    receiver object;
+    allocation_counter counter( state );
+    for( auto _ : state )
+    {
+        hpp::function<void(int)> f;
+        f.connect( &object, &receiver::method );
+        benchmark::DoNotOptimize( f );
+        f.disconnect();
+    }
+}
+BENCHMARK( member_connect_churn );
+
+static void lifetime_sentinel_churn( benchmark::State& state )
+{
+    allocation_counter counter( state );
+    for( auto _ : state )
+    {
+        sentinel_receiver object;
+        hpp::function<void(int)> f;
+        f.connect( object.get_sentinel(), static_cast<receiver*>(&object), &receiver::method );
+        benchmark::DoNotOptimize( f );
+    }
+}
+BENCHMARK( lifetime_sentinel_churn );
+
+static void intrusive_sentinel_churn( benchmark::State& state )
+{
+    allocation_counter counter( state );
+    for( auto _ : state )
+    {
+        intrusive_receiver object;
+        hpp::function<void(int)> f;
+        f.connect( object.get_sentinel(), static_cast<receiver*>(&object), &receiver::method );
+        benchmark::DoNotOptimize( f );
+    }
+}
+BENCHMARK( intrusive_sentinel_churn );
+
+static void compact_sentinel_churn( benchmark::State& state )
+{
+    allocation_counter counter( state );
+    for( auto _ : state )
+    {
+        intrusive_receiver object;
+        hpp::compact_function<void(int)> f;
+        f.connect( object.get_sentinel(), static_cast<receiver*>(&object), &receiver::method );
+        benchmark::DoNotOptimize( f );
+    }
+}
+BENCHMARK( compact_sentinel_churn );
+
+BENCHMARK_MAIN();
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "function.hpp"
+
+namespace hpp
+{
+// Deferred dispatch
+
+    template<typename FunctionSignature, std::size_t Capacity>
+    class event_queue;
+
+    // Bounded lock-free multi-producer single-consumer queue of call arguments. Producers post() argument
+    // tuples into pre-allocated cells without running any callee code; the owner thread drains them in
+    // batches with dispatch() into a function, signal or any callable accepting the arguments
+    template<typename... Args, std::size_t Capacity>
+    class event_queue<void(Args...), Capacity>
+    {
+        static_assert( Capacity >= 2 && ( Capacity & (Capacity - 1) ) == 0, "Event queue capacity must be a power of two" );
+
+        using tuple_t = std::tuple<typename std::decay<Args>::type...>;
+
+        struct alignas(64) _cell
+        {
+            std::atomic<std::size_t> sequence;
+            bool filled;
+            alignas(tuple_t) unsigned char storage[sizeof(tuple_t)];
+
+            auto arguments() -> tuple_t&
+            {
+                return *std::launder( reinterpret_cast<tuple_t*>(storage) );
+            }
+        };
+
+        template<typename Target, typename = void>
+        struct _has_validity : std::false_type {};
+
+        template<typename Target>
+        struct _has_validity<Target, std::void_t<decltype(std::declval<const Target&>().valid())>> : std::true_type {};
+
+        template<typename Target>
+        static auto is_expired( const Target& target ) -> bool
+        {
+            if constexpr( _has_validity<Target>::value )
+            {
+                return !target.valid();
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        std::unique_ptr<_cell[]> cells_ = std::make_unique<_cell[]>( Capacity );
+        alignas(64) std::atomic<std::size_t> enqueue_position_ { 0 };
+        alignas(64) std::size_t dequeue_position_ = 0;
+
+    public:
+
+        event_queue()
+        {
+            for( std::size_t i = 0; i < Capacity; ++i )
+            {
+                cells_[i].sequence.store( i, std::memory_order_relaxed );
+            }
+        }
+
+        event_queue( const event_queue& ) = delete;
+        auto operator=( const event_queue& ) -> event_queue& = delete;
+
+        ~event_queue()
+        {
+            clear();
+        }
+
+        // Thread-safe; returns false without blocking when the queue is full. If copying or moving an argument
+        // throws, the exception propagates and the claimed cell is published empty, so dispatch skips it
+        template<typename... PostArgs>
+        auto post( PostArgs&&... args ) -> bool
+        {
+            auto position = enqueue_position_.load( std::memory_order_relaxed );
+
+            for( ;; )
+            {
+                auto& cell = cells_[position & (Capacity - 1)];
+                const auto sequence = cell.sequence.load( std::memory_order_acquire );
+                const auto difference = static_cast<std::ptrdiff_t>( sequence ) - static_cast<std::ptrdiff_t>( position );
+
+                if( difference == 0 )
+                {
+                    if( enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed) )
+                    {
+                        if constexpr( std::is_nothrow_constructible<tuple_t, PostArgs&&...>::value )
+                        {
+                            ::new( static_cast<void*>(cell.storage) ) tuple_t( std::forward<PostArgs>(args)... );
+                            cell.filled = true;
+                        }
+                        else
+                        {
+                            try
+                            {
+                                ::new( static_cast<void*>(cell.storage) ) tuple_t( std::forward<PostArgs>(args)... );
+                                cell.filled = true;
+                            }
+                            catch( ... )
+                            {
+                                cell.filled = false;
+                                cell.sequence.store( position + 1, std::memory_order_release );
+                                throw;
+                            }
+                        }
+
+                        cell.sequence.store( position + 1, std::memory_order_release );
+                        return true;
+                    }
+                }
+                else if( difference < 0 )
+                {
+                    return false;
+                }
+                else
+                {
+                    position = enqueue_position_.load( std::memory_order_relaxed );
+                }
+            }
+        }
+
+        // Owner thread only. Calls the target with up to max_count queued argument sets and returns how
+        // many were consumed; while the target is a function that expired or is empty they are dropped uncalled.
+        // Expiry is checked for every item, since an earlier call of the batch may release the receiver.
+        // Cells left empty by a throwing post are released without counting
+        template<typename Target>
+        auto dispatch( const Target& target,
+                       std::size_t max_count = Capacity ) -> std::size_t
+        {
+            std::size_t count = 0;
+
+            while( count < max_count )
+            {
+                auto& cell = cells_[dequeue_position_ & (Capacity - 1)];
+                if( cell.sequence.load(std::memory_order_acquire) != dequeue_position_ + 1 )
+                {
+                    break;
+                }
+
+                if( !cell.filled )
+                {
+                    cell.sequence.store( dequeue_position_ + Capacity, std::memory_order_release );
+                    ++dequeue_position_;
+                    continue;
+                }
+
+                // Released before the call so that a passthrough exception does not leave the cell occupied
+                tuple_t arguments( std::move(cell.arguments()) );
+                cell.arguments().~tuple_t();
+                cell.sequence.store( dequeue_position_ + Capacity, std::memory_order_release );
+                ++dequeue_position_;
+                ++count;
+
+                if( !is_expired(target) )
+                {
+                    std::apply( target, std::move(arguments) );
+                }
+            }
+
+            return count;
+        }
+
+        // Owner thread only. Drops every queued argument set
+        void clear()
+        {
+            struct _discard
+            {
+                void operator()( const typename std::decay<Args>::type&... ) const {}
+            };
+
+            while( dispatch(_discard{}) != 0 )
+            {}
+        }
+
+        auto empty() const -> bool
+        {
+            return cells_[dequeue_position_ & (Capacity - 1)].sequence.load( std::memory_order_acquire ) != dequeue_position_ + 1;
+        }
+
+        static constexpr auto capacity() -> std::size_t
+        {
+            return Capacity;
+        }
+    };
+
+    template<typename FunctionSignature, std::size_t Capacity, typename Target = function<FunctionSignature>>
+    class queued;
+
+    // Function or signal whose calls can be posted from any thread and run later on the owner thread,
+    // e.g. queued<void(int), 256, signal<void(int)>>. Connect and dispatch from the owner thread only
+    template<typename... Args, std::size_t Capacity, typename Target>
+    class queued<void(Args...), Capacity, Target>
+    {
+        Target target_;
+        event_queue<void(Args...), Capacity> queue_;
+
+    public:
+
+        // The arguments are forwarded to the target constructor
+        template<typename... TargetArgs>
+        explicit queued( TargetArgs&&... args )
+            : target_( std::forward<TargetArgs>(args)... )
+        {}
+
+        auto target() -> Target& { return target_; }
+        auto target() const -> const Target& { return target_; }
+
+        // Thread-safe and never runs the target; returns false when the queue is full
+        template<typename... PostArgs>
+        auto post( PostArgs&&... args ) -> bool
+        {
+            return queue_.post( std::forward<PostArgs>(args)... );
+        }
+
+        // Owner thread only. Runs up to max_count posted calls and returns how many were consumed
+        auto dispatch( std::size_t max_count = Capacity ) -> std::size_t
+        {
+            return queue_.dispatch( target_, max_count );
+        }
+
+        // Calls the target directly on the calling thread
+        template<typename... CallArgs>
+        auto operator()( CallArgs&&... args ) const -> decltype(auto)
+        {
+            return target_( std::forward<CallArgs>(args)... );
+        }
+
+        auto empty() const -> bool
+        {
+            return queue_.empty();
+        }
+
+        void clear()
+        {
+            queue_.clear();
+        }
+    };
+
+} // namespace hpp
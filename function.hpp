@@ -1,8 +1,34 @@
 #pragma once
 
 #include <optional>
+#include <variant>
 #include <functional>
 #include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <memory_resource>
+#include <array>
+#include <chrono>
+#if __has_include(<version>)
+#include <version>
+#endif
+#if defined(__cpp_lib_expected)
+#include <expected>
+#endif
+#if defined(__cpp_lib_span)
+#include <span>
+#endif
 
 namespace hpp
 {
@@ -11,28 +37,172 @@ namespace hpp
 
     static constexpr auto& no_value = std::nullopt;
 
+    // Result of calling a value function: an optional value, or an optional reference wrapper for reference returns
+    template<typename ReturnType>
+    struct _function_result
+    {
+        static_assert( !std::is_rvalue_reference<ReturnType>::value, "Function return type cannot be an rvalue reference" );
+        using type = optional<ReturnType>;
+    };
+
+    template<typename T>
+    struct _function_result<T&>
+    {
+        using type = optional<std::reference_wrapper<T>>;
+    };
+
+    template<typename ReturnType>
+    using function_result_t = typename _function_result<ReturnType>::type;
+
+    // Converts to the result of the invocation, so that guaranteed copy elision constructs it in its final storage
+    template<typename Invocation>
+    struct _deferred_result
+    {
+        Invocation& invocation;
+
+        operator decltype(std::declval<Invocation&>()())() const
+        {
+            return invocation();
+        }
+    };
+
+    struct _unrelated_t {};
+
+    // Results are constructed in place from the call through a conversion operator, unless the return type has
+    // a constructor template that would capture the conversion object itself
+    template<typename ReturnType>
+    constexpr bool _constructs_in_place = !std::is_reference<ReturnType>::value &&
+                                          !std::is_constructible<ReturnType, _unrelated_t>::value;
+
+    template<typename ReturnType, typename Invocation>
+    auto _make_result( Invocation&& invocation ) -> function_result_t<ReturnType>
+    {
+        if constexpr( _constructs_in_place<ReturnType> )
+        {
+            return function_result_t<ReturnType>{ std::in_place, _deferred_result<Invocation>{ invocation } };
+        }
+        else
+        {
+            return function_result_t<ReturnType>{ invocation() };
+        }
+    }
+
+    template<typename ReturnType, typename Invocation>
+    void _emplace_result( function_result_t<ReturnType>& result, Invocation&& invocation )
+    {
+        if constexpr( _constructs_in_place<ReturnType> )
+        {
+            result.emplace( _deferred_result<Invocation>{ invocation } );
+        }
+        else
+        {
+            result.emplace( invocation() );
+        }
+    }
+
+#if defined(__cpp_lib_span)
+    template<typename T>
+    using span = std::span<T>;
+#else
+    // Minimal contiguous range view used by the batch call interface before C++20
     template<typename T>
+    class span
+    {
+        T* data_ = nullptr;
+        std::size_t size_ = 0;
+
+    public:
+
+        span() noexcept = default;
+
+        span( T* data, std::size_t size ) noexcept
+            : data_( data ),
+              size_( size )
+        {}
+
+        template<typename Container, typename = typename std::enable_if<std::is_convertible<decltype(std::data(std::declval<Container&>())), T*>::value>::type>
+        span( Container& container ) noexcept
+            : span( std::data(container), std::size(container) )
+        {}
+
+        auto data() const -> T* { return data_; }
+        auto size() const -> std::size_t { return size_; }
+        auto empty() const -> bool { return size_ == 0; }
+        auto begin() const -> T* { return data_; }
+        auto end() const -> T* { return data_ + size_; }
+        auto operator[]( std::size_t index ) const -> T& { return data_[index]; }
+    };
+#endif
+
+    // Counter type of generation based sentinels, a sentinel expires once its counter moves past the captured value
+    using generation_t = std::uint32_t;
+    using generation_counter_t = std::atomic<generation_t>;
+
+    // Lifetime handle of a function: either a weak pointer or a generation counter with its captured value,
+    // held as alternatives so that neither form pays for the other
     class sentinel_t
     {
-        std::weak_ptr<T> ptr_;
-        
+        struct _generation_ref
+        {
+            const generation_counter_t* counter;
+            generation_t generation;
+            bool synchronized;
+        };
+
+        std::variant<std::weak_ptr<void>, _generation_ref> state_ {};
+
     public:
 
         sentinel_t() = default;
 
+        template<typename T>
         sentinel_t( const std::shared_ptr<T>& ptr )
             : sentinel_t( std::weak_ptr<T>(ptr) ) 
         {}
 
+        template<typename T>
         sentinel_t( const std::weak_ptr<T>& ptr ) 
-            : ptr_( ptr )
+            : state_( std::weak_ptr<void>(ptr) )
+        {}
+
+        sentinel_t( const generation_counter_t& counter,
+                    generation_t generation,
+                    bool synchronized = false )
+            : state_( _generation_ref{ &counter, generation, synchronized } )
         {}
 
         auto expired() const -> bool
         {
-            return ptr_.expired();
+            if( const auto* ref = std::get_if<_generation_ref>(&state_) )
+            {
+                return ref->counter->load( std::memory_order_acquire ) != ref->generation;
+            }
+
+            return std::get<std::weak_ptr<void>>( state_ ).expired();
+        }
+
+        // Generation counter of generation based sentinels, nullptr for weak pointer based ones
+        auto generation_counter() const -> const generation_counter_t*
+        {
+            const auto* ref = std::get_if<_generation_ref>( &state_ );
+            return ref != nullptr ? ref->counter : nullptr;
+        }
+
+        auto generation() const -> generation_t
+        {
+            const auto* ref = std::get_if<_generation_ref>( &state_ );
+            return ref != nullptr ? ref->generation : 0;
+        }
+
+        // If set, calls pin the epoch domain so that the owner cannot finish retiring while they run
+        auto is_synchronized() const -> bool
+        {
+            const auto* ref = std::get_if<_generation_ref>( &state_ );
+            return ref != nullptr && ref->synchronized;
         }
     };
+
+    static_assert( sizeof(sentinel_t) <= sizeof(std::weak_ptr<void>) + sizeof(void*), "Function: Sentinels must not grow past a weak pointer and a tag" );
     
     using sentinel_opt_t = optional<sentinel_t>;
 
@@ -52,274 +222,2985 @@ namespace hpp
         }
     };
 
-    template<typename ReturnType>
-    auto has_value( const ReturnType& val ) -> bool
+    // Process-wide table of generation counters. Blocks are never freed, so counter addresses stay valid
+    // for any sentinel that outlives its owner; released counters are bumped and recycled. Block i holds
+    // base_size << i counters, which gives every counter a stable 31-bit index that can be resolved without locking.
+    // Threads acquire and release through a local cache that exchanges batches with the shared free list, so only
+    // one in cache_size / 2 operations takes the lock. Counters close to wrapping around are retired instead of
+    // recycled, so a stale sentinel can never match a reused counter again
+    class _generation_pool
     {
-        return ( val != no_value );
-    }
+        static constexpr std::uint32_t base_size = 1024;
+        static constexpr std::uint32_t base_bits = 10;
+        static constexpr std::size_t max_blocks = 21;
+        static constexpr std::size_t cache_size = 64;
 
-    // Use to resolve overloaded functions
-    #ifndef get_overload
-    #define get_overload( function ) \
-    []( auto&&... args ) -> decltype(auto) { return function(std::forward<decltype(args)>(args)...); }
-    #else
-    static_assert( false, "Function: Definition of get_overload already exists!" );
-    #endif
+        // Leaves room for the bumps of connection_group::disconnect_all on a counter that is still in use
+        static constexpr generation_t retire_after = ~generation_t{ 0 } - ( generation_t{ 1 } << 16 );
 
-    // Use to resolve overloaded member functions
-    #ifndef get_overload_member
-    #define get_overload_member( class_ptr, function ) \
-    [class_ptr]( auto&&... args ) -> decltype(auto) { return (class_ptr)->function(std::forward<decltype(args)>(args)...); }
-    #else
-    static_assert( false, "Function: Definition of get_overload_member already exists!" );
-    #endif
+        // Hands its counters back to the shared free list when the thread exits
+        struct _thread_cache
+        {
+            std::vector<generation_counter_t*> counters;
 
-// Enablers
+            _thread_cache()
+            {
+                counters.reserve( cache_size + 1 );
+            }
 
-    template<typename T>
-    constexpr auto is_sentinel()
-    {
-        return std::is_same<T, sentinel_t>::value ||
-               std::is_same<T, sentinel_opt_t>::value ||
-               std::is_same<T, std::nullopt_t>::value;
-    }
+            ~_thread_cache()
+            {
+                instance().give_back( counters, counters.size() );
+            }
+        };
 
-    template<typename Source, typename Target>
-    constexpr auto is_different_function()
-    {
-        return !std::is_same<Source, typename std::decay<Target>::type>::value;
-    }
+        static_assert( base_size == (1u << base_bits), "Function: Generation pool base size must match its bit count" );
 
-    template<typename Source, typename Target>
-    using _function_enabler = typename std::enable_if<is_different_function<Source, Target>()>::type;
+        std::mutex mutex_;
+        std::array<std::atomic<generation_counter_t*>, max_blocks> blocks_ {};
+        std::size_t block_count_ = 0;
+        std::vector<generation_counter_t*> free_;
 
-    template<typename Source, typename Target, typename Sentinel>
-    using _sentinel_function_enabler = typename std::enable_if<is_different_function<Source, Target>() && is_sentinel<Sentinel>()>::type;
+        static constexpr auto floor_log2( std::uint32_t value ) noexcept -> std::uint32_t
+        {
+            std::uint32_t result = 0;
+            for( std::uint32_t shift = 16; shift > 0; shift /= 2 )
+            {
+                if( value >> shift )
+                {
+                    value >>= shift;
+                    result += shift;
+                }
+            }
+            return result;
+        }
 
-    // Check if type is void
-    template<typename T>
-    using is_void = std::is_same<T, void>;
+    public:
 
-    // Void return enabler
-    template<typename ReturnType>
-    using returns_void = typename std::enable_if<is_void<ReturnType>::value>::type;
+        // Largest index plus one, indices fit in 31 bits
+        static constexpr std::uint32_t max_counters = base_size * ( (1u << max_blocks) - 1 );
 
-    // Value return enabler
-    template<typename ReturnType>
-    using returns_value = typename std::enable_if<!is_void<ReturnType>::value>::type;
+        static auto instance() -> _generation_pool&
+        {
+            // Intentionally leaked to stay alive during static destruction
+            static auto* pool = new _generation_pool();
+            return *pool;
+        }
 
-// Exceptions
+    private:
 
-    // Can be thrown from the function to force a return value of nullopt for error handling
-    struct function_exception : public std::exception
-    {
-        explicit function_exception( bool passthrough = false )
-            : error_msg_( "Unspecified error" ),
-              passtrhrough_( passthrough )
-        {}
+        static auto local_cache() -> std::vector<generation_counter_t*>&
+        {
+            thread_local _thread_cache cache;
+            return cache.counters;
+        }
 
-        explicit function_exception( const char* message,
-                                     bool passthrough = false )
-            : error_msg_( message ),
-              passtrhrough_( passthrough )
-        {}
+        void give_back( std::vector<generation_counter_t*>& cache, std::size_t count )
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            free_.insert( free_.end(), cache.end() - static_cast<std::ptrdiff_t>(count), cache.end() );
+            cache.resize( cache.size() - count );
+        }
 
-        explicit function_exception( std::string message,
-                                     bool passthrough = false )
-            : error_msg_( std::move(message) ),
-              passtrhrough_( passthrough )
-        {}
+        void refill( std::vector<generation_counter_t*>& cache )
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
 
-        auto what() const noexcept -> const char* override
+            if( free_.empty() )
+            {
+                if( block_count_ == max_blocks )
+                {
+                    throw std::length_error( "Function: Generation pool capacity exceeded" );
+                }
+
+                const std::size_t size = std::size_t{ base_size } << block_count_;
+                auto* block = new generation_counter_t[size] {};
+                blocks_[block_count_++].store( block, std::memory_order_release );
+
+                free_.reserve( free_.size() + size );
+                for( auto i = size; i > 0; --i )
+                {
+                    free_.push_back( block + i - 1 );
+                }
+            }
+
+            const auto count = std::min( free_.size(), cache_size / 2 );
+            cache.insert( cache.end(), free_.end() - static_cast<std::ptrdiff_t>(count), free_.end() );
+            free_.resize( free_.size() - count );
+        }
+
+    public:
+
+        auto acquire() -> generation_counter_t*
         {
-            return error_msg_.c_str();
+            auto& cache = local_cache();
+            if( cache.empty() )
+            {
+                refill( cache );
+            }
+
+            auto* counter = cache.back();
+            cache.pop_back();
+            return counter;
         }
 
-        auto is_passthrough() const noexcept -> bool
+        void release( generation_counter_t* counter )
         {
-            return passtrhrough_;
+            if( counter->fetch_add(1, std::memory_order_release) + 1 >= retire_after )
+            {
+                return;
+            }
+
+            auto& cache = local_cache();
+            cache.push_back( counter );
+
+            if( cache.size() > cache_size )
+            {
+                give_back( cache, cache_size / 2 );
+            }
         }
 
-    protected:
+        // Index of a pooled counter, or no_value if the counter belongs to another owner, e.g. a sentinel_registry
+        auto index_of( const generation_counter_t* counter ) const noexcept -> optional<std::uint32_t>
+        {
+            std::uint32_t first = 0;
+            for( std::size_t i = 0; i < max_blocks; ++i )
+            {
+                const auto* block = blocks_[i].load( std::memory_order_acquire );
+                if( block == nullptr )
+                {
+                    break;
+                }
 
-        // Exception description
-        const std::string error_msg_;
+                const std::size_t size = std::size_t{ base_size } << i;
+                if( std::less_equal<>{}( block, counter ) && std::less<>{}( counter, block + size ) )
+                {
+                    return first + static_cast<std::uint32_t>( counter - block );
+                }
 
-        // If set, the exception will be rethrown outside the function for external handling
-        const bool passtrhrough_;
+                first += static_cast<std::uint32_t>( size );
+            }
+
+            return no_value;
+        }
+
+        // Counter of an index returned by index_of
+        auto counter( std::uint32_t index ) const noexcept -> const generation_counter_t&
+        {
+            const auto biased = index + base_size;
+            const auto block = floor_log2( biased ) - base_bits;
+            return blocks_[block].load( std::memory_order_acquire )[biased - (base_size << block)];
+        }
     };
 
-// Function definition
+    // Allocation-free alternative to lifetime_sentinel. Validity is a generation counter in a pooled slot,
+    // so copying the sentinel does not touch any reference count and checking it is a single load.
+    // Copies of the owner receive their own slot
+    class intrusive_lifetime_sentinel
+    {
+        generation_counter_t* _counter_ = _generation_pool::instance().acquire();
+        mutable sentinel_t _sentinel_ { *_counter_, _counter_->load(std::memory_order_relaxed) };
 
-    // Basic function methods
-    template<typename FunctionSignature>
-    struct _function_container
+    public:
+
+        intrusive_lifetime_sentinel() = default;
+
+        intrusive_lifetime_sentinel( const intrusive_lifetime_sentinel& /*other*/ )
+            : intrusive_lifetime_sentinel()
+        {}
+
+        auto operator=( const intrusive_lifetime_sentinel& /*other*/ ) -> intrusive_lifetime_sentinel&
+        {
+            return *this;
+        }
+
+        ~intrusive_lifetime_sentinel()
+        {
+            _generation_pool::instance().release( _counter_ );
+        }
+
+        auto get_sentinel() const -> sentinel_t&
+        {
+            return _sentinel_;
+        }
+    };
+
+    // Contiguous slot map of generation counters for large groups of short-lived objects. Handles are
+    // {index, generation} pairs and sentinels read the counter array directly, so expiry checks touch
+    // dense memory and expiring a batch is a linear array write. Capacity is fixed so that counter addresses
+    // stay stable; the registry must outlive every function connected through it. Not thread-safe for writers
+    class sentinel_registry
     {
-        using func_t = std::function<FunctionSignature>;
+    public:
 
-    // Utilities
+        struct handle
+        {
+            std::uint32_t index = 0;
+            generation_t generation = 0;
+        };
 
-        void disconnect() const
+        explicit sentinel_registry( std::size_t capacity )
+            : counters_( std::make_unique<generation_counter_t[]>(capacity) ),
+              capacity_( capacity )
         {
-            slot_ = {};
+            free_.reserve( capacity );
+            for( std::size_t i = capacity; i > 0; --i )
+            {
+                free_.push_back( static_cast<std::uint32_t>(i - 1) );
+            }
         }
 
-        auto empty() const -> bool
+        sentinel_registry( const sentinel_registry& ) = delete;
+        auto operator=( const sentinel_registry& ) -> sentinel_registry& = delete;
+
+        auto create() -> handle
         {
-            return !slot_.func;
+            if( free_.empty() )
+            {
+                throw std::length_error( "Function: Sentinel registry capacity exceeded" );
+            }
+
+            const auto index = free_.back();
+            free_.pop_back();
+            return { index, counters_[index].load(std::memory_order_relaxed) };
         }
 
-        auto expired() const -> bool
+        void expire( const handle& h )
         {
-            if( slot_.sentinel == no_value )
+            if( !expired(h) )
             {
-                return false;
+                counters_[h.index].store( h.generation + 1, std::memory_order_release );
+                free_.push_back( h.index );
             }
+        }
 
-            return slot_.sentinel.value().expired();
+        template<typename Iterator>
+        void expire( Iterator first, Iterator last )
+        {
+            for( ; first != last; ++first )
+            {
+                expire( *first );
+            }
         }
 
-        auto valid() const -> bool
+        // Invalidates every live handle at once and recycles all slots
+        void expire_all()
         {
-            return !expired() && !empty();
+            free_.clear();
+            for( std::size_t i = capacity_; i > 0; --i )
+            {
+                counters_[i - 1].fetch_add( 1, std::memory_order_release );
+                free_.push_back( static_cast<std::uint32_t>(i - 1) );
+            }
         }
 
-        operator bool() const
+        auto expired( const handle& h ) const -> bool
         {
-            return valid();
+            return counters_[h.index].load( std::memory_order_acquire ) != h.generation;
         }
 
-    protected:
+        auto get_sentinel( const handle& h ) const -> sentinel_t
+        {
+            return { counters_[h.index], h.generation };
+        }
 
-        template<typename... FunctionArgs>
-        void connect_impl( const sentinel_opt_t& sentinel, FunctionArgs&&... args )
+        auto size() const -> std::size_t
+        {
+            return capacity_ - free_.size();
+        }
+
+        auto capacity() const -> std::size_t
         {
-            slot_.func = { std::forward<FunctionArgs>(args)... };
-            slot_.sentinel = sentinel;
+            return capacity_;
+        }
+
+    private:
+
+        std::unique_ptr<generation_counter_t[]> counters_;
+        std::vector<std::uint32_t> free_;
+        std::size_t capacity_;
+    };
+
+    template<typename ReturnType>
+    auto has_value( const ReturnType& val ) -> bool
+    {
+        return ( val != no_value );
+    }
+
+    // Use to resolve overloaded functions
+    #ifndef get_overload
+    #define get_overload( function ) \
+    []( auto&&... args ) -> decltype(auto) { return function(std::forward<decltype(args)>(args)...); }
+    #else
+    static_assert( false, "Function: Definition of get_overload already exists!" );
+    #endif
+
+    // Use to resolve overloaded member functions
+    #ifndef get_overload_member
+    #define get_overload_member( class_ptr, function ) \
+    [class_ptr]( auto&&... args ) -> decltype(auto) { return (class_ptr)->function(std::forward<decltype(args)>(args)...); }
+    #else
+    static_assert( false, "Function: Definition of get_overload_member already exists!" );
+    #endif
+
+    // Shared sentinel for many functions that are torn down together, e.g. everything a plugin connected.
+    // disconnect_all() expires every function connected so far with a single counter bump, in constant time;
+    // functions connected afterwards use the new generation. Destroying the group disconnects everything.
+    // The current generation is the counter itself, so disconnect_all() may run concurrently with get_sentinel()
+    class connection_group
+    {
+        generation_counter_t* _counter_ = _generation_pool::instance().acquire();
+
+    public:
+
+        connection_group() = default;
+        connection_group( const connection_group& ) = delete;
+        auto operator=( const connection_group& ) -> connection_group& = delete;
+
+        ~connection_group()
+        {
+            _generation_pool::instance().release( _counter_ );
+        }
+
+        void disconnect_all()
+        {
+            _counter_->fetch_add( 1, std::memory_order_release );
+        }
+
+        // Sentinel of the current generation. One taken while disconnect_all() runs may already be expired
+        auto get_sentinel() const -> sentinel_t
+        {
+            return { *_counter_, _counter_->load(std::memory_order_acquire) };
+        }
+    };
+
+// Epoch based reclamation
+
+    // Process-wide read-copy-update domain. Readers announce the epoch they entered in a per-thread,
+    // cache line sized record and never write shared memory; writers advance the global epoch when unlinking
+    // shared data and free it once every reader that could still observe it has left its critical section
+    class _epoch_domain
+    {
+        static constexpr std::uint64_t quiescent = 0;
+
+        struct alignas(64) _record
+        {
+            std::atomic<std::uint64_t> epoch { quiescent };
+            std::atomic<bool> in_use { false };
+            std::size_t depth = 0;
+            _record* next = nullptr;
+        };
+
+        // Binds a record to the current thread and hands it back on thread exit
+        struct _thread_record
+        {
+            _record& record;
+
+            ~_thread_record()
+            {
+                record.epoch.store( quiescent, std::memory_order_release );
+                record.in_use.store( false, std::memory_order_release );
+            }
+        };
+
+        std::atomic<std::uint64_t> global_epoch_ { 1 };
+        std::atomic<_record*> records_ { nullptr };
+
+        auto acquire_record() -> _record&
+        {
+            for( auto* record = records_.load(std::memory_order_acquire); record != nullptr; record = record->next )
+            {
+                bool expected = false;
+                if( !record->in_use.load(std::memory_order_relaxed) &&
+                    record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire) )
+                {
+                    return *record;
+                }
+            }
+
+            // Records are never freed, so readers and writers can walk the list without synchronization
+            auto* record = new _record();
+            record->in_use.store( true, std::memory_order_relaxed );
+            record->next = records_.load( std::memory_order_relaxed );
+            while( !records_.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed) )
+            {}
+
+            return *record;
+        }
+
+        auto local_record() -> _record&
+        {
+            thread_local _thread_record local { acquire_record() };
+            return local.record;
+        }
+
+    public:
+
+        static auto instance() -> _epoch_domain&
+        {
+            // Intentionally leaked to stay alive during static destruction
+            static auto* domain = new _epoch_domain();
+            return *domain;
+        }
+
+        void enter()
+        {
+            auto& record = local_record();
+            if( record.depth++ == 0 )
+            {
+                record.epoch.store( global_epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed );
+                std::atomic_thread_fence( std::memory_order_seq_cst );
+            }
+        }
+
+        void exit()
+        {
+            auto& record = local_record();
+            if( --record.depth == 0 )
+            {
+                record.epoch.store( quiescent, std::memory_order_release );
+            }
+        }
+
+        auto in_critical_section() -> bool
+        {
+            return local_record().depth != 0;
+        }
+
+        // To be called after unlinking shared data; the returned epoch is passed to is_safe or synchronize
+        auto advance() -> std::uint64_t
+        {
+            return global_epoch_.fetch_add( 1, std::memory_order_seq_cst ) + 1;
+        }
+
+        // Check if no reader that entered before the given epoch is left, ignoring the current thread if requested
+        auto is_safe( std::uint64_t epoch, bool ignore_current_thread = false ) -> bool
+        {
+            const auto* self = ignore_current_thread ? &local_record() : nullptr;
+
+            for( auto* record = records_.load(std::memory_order_acquire); record != nullptr; record = record->next )
+            {
+                if( record == self )
+                {
+                    continue;
+                }
+
+                const auto observed = record->epoch.load( std::memory_order_acquire );
+                if( observed != quiescent && observed < epoch )
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Blocks until every other thread has left the critical sections it entered before the given epoch
+        void synchronize( std::uint64_t epoch )
+        {
+            while( !is_safe(epoch, true) )
+            {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    // Read-side critical section of the epoch domain
+    class epoch_guard
+    {
+    public:
+
+        epoch_guard()
+        {
+            _epoch_domain::instance().enter();
+        }
+
+        epoch_guard( const epoch_guard& ) = delete;
+        auto operator=( const epoch_guard& ) -> epoch_guard& = delete;
+
+        ~epoch_guard()
+        {
+            _epoch_domain::instance().exit();
+        }
+    };
+
+    // Lifetime sentinel that keeps its owner alive for the duration of every call made through it, also
+    // across threads. Calls run inside an epoch critical section, so readers only write their own per-thread
+    // record; retire() expires the sentinel and waits until calls started on other threads have returned.
+    // Call retire() first thing in the owner destructor, before any state used by the callbacks is destroyed.
+    // The wait covers every epoch critical section, so retire() also waits for unrelated readers such as
+    // concurrent_signal emissions. Retiring from inside a critical section, including a synchronized call or a
+    // callback destroying its own owner, could wait on a thread that in turn waits for it. retire() therefore
+    // throws std::logic_error there, which terminates when it happens in the owner destructor
+    class synchronized_lifetime_sentinel
+    {
+        generation_counter_t* _counter_ = _generation_pool::instance().acquire();
+        mutable sentinel_t _sentinel_ { *_counter_, _counter_->load(std::memory_order_relaxed), true };
+        bool _retired_ = false;
+
+    public:
+
+        synchronized_lifetime_sentinel() = default;
+
+        synchronized_lifetime_sentinel( const synchronized_lifetime_sentinel& /*other*/ )
+            : synchronized_lifetime_sentinel()
+        {}
+
+        auto operator=( const synchronized_lifetime_sentinel& /*other*/ ) -> synchronized_lifetime_sentinel&
+        {
+            return *this;
+        }
+
+        ~synchronized_lifetime_sentinel()
+        {
+            retire();
+            _generation_pool::instance().release( _counter_ );
+        }
+
+        void retire()
+        {
+            if( !_retired_ )
+            {
+                auto& domain = _epoch_domain::instance();
+                if( domain.in_critical_section() )
+                {
+                    throw std::logic_error( "Function: Synchronized sentinels cannot be retired inside an epoch critical section" );
+                }
+
+                _retired_ = true;
+                _counter_->fetch_add( 1, std::memory_order_seq_cst );
+                domain.synchronize( domain.advance() );
+            }
+        }
+
+        auto get_sentinel() const -> sentinel_t&
+        {
+            return _sentinel_;
+        }
+    };
+
+    // Keeps a call pinned in the epoch domain when made through a synchronized sentinel
+    class _sentinel_pin
+    {
+        const bool pinned_;
+
+    public:
+
+        explicit _sentinel_pin( bool synchronized )
+            : pinned_( synchronized )
+        {
+            if( pinned_ )
+            {
+                _epoch_domain::instance().enter();
+            }
+        }
+
+        explicit _sentinel_pin( const sentinel_opt_t& sentinel )
+            : _sentinel_pin( sentinel != no_value && sentinel->is_synchronized() )
+        {}
+
+        _sentinel_pin( const _sentinel_pin& ) = delete;
+        auto operator=( const _sentinel_pin& ) -> _sentinel_pin& = delete;
+
+        ~_sentinel_pin()
+        {
+            if( pinned_ )
+            {
+                _epoch_domain::instance().exit();
+            }
+        }
+    };
+
+    // Eight byte sentinel handle of compact storages: the pool index of a generation counter, with the top bit
+    // marking synchronized sentinels, and the captured generation. Only sentinels of intrusive_lifetime_sentinel,
+    // synchronized_lifetime_sentinel and connection_group, whose counters live in the generation pool, can be packed
+    class _compact_sentinel
+    {
+        static constexpr std::uint32_t none = ~std::uint32_t{ 0 };
+        static constexpr std::uint32_t synchronized_bit = std::uint32_t{ 1 } << 31;
+
+        std::uint32_t index_ = none;
+        generation_t generation_ = 0;
+
+    public:
+
+        _compact_sentinel() = default;
+
+        _compact_sentinel( const sentinel_opt_t& sentinel )
+        {
+            if( sentinel == no_value )
+            {
+                return;
+            }
+
+            const auto index = sentinel->generation_counter() != nullptr
+                ? _generation_pool::instance().index_of( sentinel->generation_counter() )
+                : no_value;
+
+            if( index == no_value )
+            {
+                throw std::invalid_argument( "Function: Compact functions require a generation pool sentinel" );
+            }
+
+            index_ = *index | ( sentinel->is_synchronized() ? synchronized_bit : 0 );
+            generation_ = sentinel->generation();
+        }
+
+        auto has_value() const noexcept -> bool
+        {
+            return index_ != none;
+        }
+
+        auto is_synchronized() const noexcept -> bool
+        {
+            return has_value() && ( index_ & synchronized_bit ) != 0;
+        }
+
+        auto expired() const noexcept -> bool
+        {
+            return _generation_pool::instance().counter( index_ & ~synchronized_bit ).load( std::memory_order_acquire ) != generation_;
+        }
+
+        // Unpacked sentinel, e.g. to reconnect with the same lifetime
+        auto value() const -> sentinel_opt_t
+        {
+            if( !has_value() )
+            {
+                return no_value;
+            }
+
+            return sentinel_t( _generation_pool::instance().counter(index_ & ~synchronized_bit), generation_, is_synchronized() );
+        }
+    };
+
+    static_assert( sizeof(_compact_sentinel) == 8, "Function: Compact sentinel handles must stay eight bytes" );
+
+    inline auto _sentinel_expired( const sentinel_opt_t& sentinel ) -> bool
+    {
+        return sentinel != no_value && sentinel->expired();
+    }
+
+    inline auto _sentinel_expired( const _compact_sentinel& sentinel ) noexcept -> bool
+    {
+        return sentinel.has_value() && sentinel.expired();
+    }
+
+    inline auto _sentinel_synchronized( const sentinel_opt_t& sentinel ) -> bool
+    {
+        return sentinel != no_value && sentinel->is_synchronized();
+    }
+
+    inline auto _sentinel_synchronized( const _compact_sentinel& sentinel ) noexcept -> bool
+    {
+        return sentinel.is_synchronized();
+    }
+
+    inline auto _sentinel_value( const sentinel_opt_t& sentinel ) -> const sentinel_opt_t&
+    {
+        return sentinel;
+    }
+
+    inline auto _sentinel_value( const _compact_sentinel& sentinel ) -> sentinel_opt_t
+    {
+        return sentinel.value();
+    }
+
+// Enablers
+
+    template<typename T>
+    constexpr auto is_sentinel()
+    {
+        return std::is_same<T, sentinel_t>::value ||
+               std::is_same<T, sentinel_opt_t>::value ||
+               std::is_same<T, std::nullopt_t>::value;
+    }
+
+    template<typename Source, typename Target>
+    constexpr auto is_different_function()
+    {
+        return !std::is_same<Source, typename std::decay<Target>::type>::value;
+    }
+
+    template<typename Source, typename Target>
+    using _function_enabler = typename std::enable_if<is_different_function<Source, Target>()>::type;
+
+    template<typename Source, typename Target, typename Sentinel>
+    using _sentinel_function_enabler = typename std::enable_if<is_different_function<Source, Target>() && is_sentinel<Sentinel>()>::type;
+
+    // Use to bind a member function as a compile-time constant, e.g. function( sentinel, nontype<&Class::method>, object_ptr )
+    template<auto Method>
+    struct nontype_t
+    {
+        explicit nontype_t() = default;
+    };
+
+    template<auto Method>
+    inline constexpr nontype_t<Method> nontype {};
+
+    // Check if type is void
+    template<typename T>
+    using is_void = std::is_same<T, void>;
+
+    // Void return enabler
+    template<typename ReturnType>
+    using returns_void = typename std::enable_if<is_void<ReturnType>::value>::type;
+
+    // Value return enabler
+    template<typename ReturnType>
+    using returns_value = typename std::enable_if<!is_void<ReturnType>::value>::type;
+
+// Exceptions
+
+    // Can be thrown from the function to force a return value of nullopt for error handling
+    struct function_exception : public std::exception
+    {
+        explicit function_exception( bool passthrough = false )
+            : error_msg_( "Unspecified error" ),
+              passtrhrough_( passthrough )
+        {}
+
+        explicit function_exception( const char* message,
+                                     bool passthrough = false )
+            : error_msg_( message ),
+              passtrhrough_( passthrough )
+        {}
+
+        explicit function_exception( std::string message,
+                                     bool passthrough = false )
+            : error_msg_( std::move(message) ),
+              passtrhrough_( passthrough )
+        {}
+
+        auto what() const noexcept -> const char* override
+        {
+            return error_msg_.c_str();
+        }
+
+        auto is_passthrough() const noexcept -> bool
+        {
+            return passtrhrough_;
+        }
+
+    protected:
+
+        // Exception description
+        const std::string error_msg_;
+
+        // If set, the exception will be rethrown outside the function for external handling
+        const bool passtrhrough_;
+    };
+
+// Error values
+
+    // Non-throwing alternative to function_exception: a callee returning expected<T, E> can report
+    // failure with hpp::fail( error ) and the caller receives it inside the optional result without unwinding
+#if defined(__cpp_lib_expected)
+    template<typename T, typename E>
+    using expected = std::expected<T, E>;
+
+    template<typename E>
+    using unexpected = std::unexpected<E>;
+#else
+    template<typename E>
+    class unexpected
+    {
+        E error_;
+
+    public:
+
+        template<typename Error = E, typename = typename std::enable_if<std::is_constructible<E, Error>::value>::type>
+        explicit unexpected( Error&& error )
+            : error_( std::forward<Error>(error) )
+        {}
+
+        auto error() const& noexcept -> const E& { return error_; }
+        auto error() & noexcept -> E& { return error_; }
+        auto error() && noexcept -> E&& { return std::move(error_); }
+    };
+
+    template<typename T, typename E>
+    class expected
+    {
+        template<typename U>
+        using _value_enabler = typename std::enable_if<std::is_constructible<T, U>::value &&
+                                                       is_different_function<expected, U>() &&
+                                                       is_different_function<unexpected<E>, U>()>::type;
+
+        std::variant<T, E> storage_;
+
+    public:
+
+        using value_type = T;
+        using error_type = E;
+
+        expected() = default;
+
+        template<typename U = T, typename = _value_enabler<U>>
+        expected( U&& value )
+            : storage_( std::in_place_index<0>, std::forward<U>(value) )
+        {}
+
+        template<typename Error>
+        expected( const unexpected<Error>& error )
+            : storage_( std::in_place_index<1>, error.error() )
+        {}
+
+        template<typename Error>
+        expected( unexpected<Error>&& error )
+            : storage_( std::in_place_index<1>, std::move(error).error() )
+        {}
+
+        auto has_value() const noexcept -> bool { return storage_.index() == 0; }
+        explicit operator bool() const noexcept { return has_value(); }
+
+        auto value() const& -> const T& { return std::get<0>( storage_ ); }
+        auto value() & -> T& { return std::get<0>( storage_ ); }
+        auto value() && -> T&& { return std::get<0>( std::move(storage_) ); }
+
+        auto error() const& -> const E& { return std::get<1>( storage_ ); }
+        auto error() & -> E& { return std::get<1>( storage_ ); }
+        auto error() && -> E&& { return std::get<1>( std::move(storage_) ); }
+
+        auto operator*() const& -> const T& { return value(); }
+        auto operator*() & -> T& { return value(); }
+        auto operator->() const -> const T* { return std::addressof( value() ); }
+        auto operator->() -> T* { return std::addressof( value() ); }
+
+        template<typename U>
+        auto value_or( U&& fallback ) const& -> T
+        {
+            return has_value() ? value() : static_cast<T>( std::forward<U>(fallback) );
+        }
+    };
+
+    template<typename E>
+    class expected<void, E>
+    {
+        optional<E> error_ {};
+
+    public:
+
+        using value_type = void;
+        using error_type = E;
+
+        expected() = default;
+
+        template<typename Error>
+        expected( const unexpected<Error>& error )
+            : error_( error.error() )
+        {}
+
+        template<typename Error>
+        expected( unexpected<Error>&& error )
+            : error_( std::move(error).error() )
+        {}
+
+        auto has_value() const noexcept -> bool { return !error_.has_value(); }
+        explicit operator bool() const noexcept { return has_value(); }
+
+        void value() const
+        {
+            if( error_.has_value() )
+            {
+                throw std::logic_error( "Function: Accessing the value of a failed result" );
+            }
+        }
+
+        auto error() const& -> const E& { return *error_; }
+        auto error() & -> E& { return *error_; }
+        auto error() && -> E&& { return std::move(*error_); }
+    };
+#endif
+
+    // Use to return an error value from a callee, e.g. return hpp::fail( errc::rejected );
+    template<typename E>
+    auto fail( E&& error ) -> unexpected<typename std::decay<E>::type>
+    {
+        return unexpected<typename std::decay<E>::type>( std::forward<E>(error) );
+    }
+
+    // Check if a call returning expected<T, E> was made and reported an error
+    template<typename T, typename E>
+    auto has_error( const optional<expected<T, E>>& val ) -> bool
+    {
+        return val.has_value() && !val->has_value();
+    }
+
+// Executor affinity
+
+    // Executors provide running_in_this_thread() and post( task ), e.g. an event loop, a strand or a thread pool
+    template<typename Executor, typename = void>
+    struct is_executor : std::false_type {};
+
+    template<typename Executor>
+    struct is_executor<Executor, std::void_t<decltype(static_cast<bool>(std::declval<const Executor&>().running_in_this_thread())),
+                                             decltype(std::declval<Executor&>().post(std::declval<void(*)()>()))>> : std::true_type {};
+
+    template<typename Executor>
+    using _executor_enabler = typename std::enable_if<is_executor<Executor>::value>::type;
+
+    // Calls the callable directly when already on the executor thread and posts the call otherwise. Posted calls
+    // take their arguments by move, or by copy for reference parameters, and check the sentinel again in the task,
+    // pinning synchronized sentinels while the callable runs. Shares one copy of the callable
+    template<typename Executor, typename Callable, typename... Args>
+    class _executor_bound
+    {
+        using arguments_t = std::tuple<typename std::decay<Args>::type...>;
+
+        // Executors commonly store tasks in std::function, so move-only arguments are shared to keep tasks copyable
+        static constexpr bool shares_arguments = !std::is_copy_constructible<arguments_t>::value;
+
+        Executor* executor_;
+        std::shared_ptr<Callable> callable_;
+        sentinel_opt_t sentinel_;
+
+    public:
+
+        _executor_bound( Executor& executor,
+                         std::shared_ptr<Callable> callable,
+                         const sentinel_opt_t& sentinel )
+            : executor_( &executor ),
+              callable_( std::move(callable) ),
+              sentinel_( sentinel )
+        {}
+
+        void operator()( Args... args ) const
+        {
+            if( executor_->running_in_this_thread() )
+            {
+                (*callable_)( std::forward<Args>(args)... );
+                return;
+            }
+
+            auto arguments = [&]
+            {
+                if constexpr( shares_arguments )
+                {
+                    return std::make_shared<arguments_t>( std::forward<Args>(args)... );
+                }
+                else
+                {
+                    return arguments_t( std::forward<Args>(args)... );
+                }
+            }();
+
+            executor_->post( [callable = callable_, sentinel = sentinel_, arguments = std::move(arguments)]() mutable
+            {
+                const _sentinel_pin pin { sentinel };
+                if( sentinel != no_value && sentinel->expired() )
+                {
+                    return;
+                }
+
+                try
+                {
+                    if constexpr( shares_arguments )
+                    {
+                        std::apply( *callable, std::move(*arguments) );
+                    }
+                    else
+                    {
+                        std::apply( *callable, std::move(arguments) );
+                    }
+                }
+                catch( const function_exception& e )
+                {
+                    if( e.is_passthrough() )
+                    {
+                        throw;
+                    }
+                }
+            } );
+        }
+    };
+
+    template<typename Executor, typename Callable, typename FunctionSignature>
+    struct _executor_binding
+    {
+        static_assert( !std::is_same<FunctionSignature, FunctionSignature>::value, "Function: Executor bound calls require void signatures" );
+    };
+
+    template<typename Executor, typename Callable, typename... Args>
+    struct _executor_binding<Executor, Callable, void(Args...)>
+    {
+        using type = _executor_bound<Executor, Callable, Args...>;
+    };
+
+// Batch calls
+
+    // Element type of batch call inputs: the decayed argument for single argument signatures, a tuple otherwise
+    template<typename... Args>
+    struct _batch_input
+    {
+        using type = std::tuple<typename std::decay<Args>::type...>;
+    };
+
+    template<typename Arg>
+    struct _batch_input<Arg>
+    {
+        using type = typename std::decay<Arg>::type;
+    };
+
+    template<typename ReturnType, typename... Args>
+    struct _batch_t
+    {
+        span<const typename _batch_input<Args...>::type> inputs;
+        span<function_result_t<ReturnType>> outputs;
+    };
+
+    template<typename... Args>
+    struct _batch_t<void, Args...>
+    {
+        span<const typename _batch_input<Args...>::type> inputs;
+    };
+
+    // Callables can opt into receiving whole batches by providing invoke_batch( inputs[, outputs] )
+    template<typename Callable, typename Batch, typename = void>
+    struct _accepts_batch : std::false_type {};
+
+    template<typename Callable, typename ReturnType, typename... Args>
+    struct _accepts_batch<Callable, _batch_t<ReturnType, Args...>,
+                          std::void_t<decltype(std::declval<Callable&>().invoke_batch(std::declval<_batch_t<ReturnType, Args...>&>().inputs,
+                                                                                      std::declval<_batch_t<ReturnType, Args...>&>().outputs))>> : std::true_type {};
+
+    template<typename Callable, typename... Args>
+    struct _accepts_batch<Callable, _batch_t<void, Args...>,
+                          std::void_t<decltype(std::declval<Callable&>().invoke_batch(std::declval<_batch_t<void, Args...>&>().inputs))>> : std::true_type {};
+
+    // Containers can forward whole batches to the callable, foreign containers such as std::function cannot
+    template<typename Container, typename Batch, typename = void>
+    struct _storage_accepts_batch : std::false_type {};
+
+    template<typename Container, typename Batch>
+    struct _storage_accepts_batch<Container, Batch, std::void_t<decltype(std::declval<const Container&>().invoke_batch(std::declval<Batch&>()))>> : std::true_type {};
+
+    template<typename Callable, typename ReturnType, typename... Args>
+    auto _invoke_batch( Callable& callable, _batch_t<ReturnType, Args...>& batch ) -> bool
+    {
+        if constexpr( !_accepts_batch<Callable, _batch_t<ReturnType, Args...>>::value )
+        {
+            return false;
+        }
+        else if constexpr( is_void<ReturnType>::value )
+        {
+            callable.invoke_batch( batch.inputs );
+            return true;
+        }
+        else
+        {
+            callable.invoke_batch( batch.inputs, batch.outputs );
+            return true;
+        }
+    }
+
+// Callable storage
+
+    template<typename FunctionSignature, typename Storage>
+    class _inline_function;
+
+    template<typename FunctionSignature, typename Storage>
+    class _move_only_function;
+
+    // Type-erased callable storage with a small inline buffer; larger captures are heap allocated
+    struct dynamic_storage
+    {
+        static constexpr std::size_t size = 2 * sizeof(void*);
+        static constexpr std::size_t alignment = alignof(std::max_align_t);
+        static constexpr bool copyable = true;
+        static constexpr bool heap_fallback = true;
+
+        template<typename FunctionSignature>
+        using container_t = _inline_function<FunctionSignature, dynamic_storage>;
+    };
+
+    // Fixed-size in-place callable storage; callables that do not fit are rejected at compile time
+    template<std::size_t Size, std::size_t Alignment = alignof(std::max_align_t)>
+    struct inline_storage
+    {
+        static_assert( Size >= sizeof(void*), "Inline storage must be able to hold at least a pointer" );
+        static_assert( Alignment != 0 && ( Alignment & (Alignment - 1) ) == 0, "Inline storage alignment must be a power of two" );
+
+        static constexpr std::size_t size = Size;
+        static constexpr std::size_t alignment = Alignment;
+        static constexpr bool copyable = true;
+        static constexpr bool heap_fallback = false;
+
+        template<typename FunctionSignature>
+        using container_t = _inline_function<FunctionSignature, inline_storage>;
+    };
+
+    // In-place storage for move-only callables, in the style of std::move_only_function. Callables that do not
+    // fit are heap allocated, so moving a function never allocates and never throws
+    template<std::size_t Size = 3 * sizeof(void*), std::size_t Alignment = alignof(std::max_align_t)>
+    struct move_only_storage
+    {
+        static_assert( Size >= sizeof(void*), "Move-only storage must be able to hold at least a pointer" );
+        static_assert( Alignment >= alignof(void*) && ( Alignment & (Alignment - 1) ) == 0, "Move-only storage alignment must be a power of two of at least pointer alignment" );
+
+        static constexpr std::size_t size = Size;
+        static constexpr std::size_t alignment = Alignment;
+        static constexpr bool copyable = false;
+        static constexpr bool heap_fallback = true;
+
+        template<typename FunctionSignature>
+        using container_t = _move_only_function<FunctionSignature, move_only_storage>;
+    };
+
+    // Storage for large callback tables: pointer aligned, for member function bindings and small captures, and
+    // with an eight byte sentinel handle, so that a function fits a 64 byte cache line. Sentinels must come
+    // from the generation pool (see _compact_sentinel); connecting another sentinel throws std::invalid_argument
+    template<std::size_t Size = 5 * sizeof(void*)>
+    struct compact_storage
+    {
+        static_assert( Size >= sizeof(void*), "Compact storage must be able to hold at least a pointer" );
+
+        static constexpr std::size_t size = Size;
+        static constexpr std::size_t alignment = alignof(void*);
+        static constexpr bool copyable = true;
+        static constexpr bool heap_fallback = true;
+
+        using sentinel_handle_t = _compact_sentinel;
+
+        template<typename FunctionSignature>
+        using container_t = _inline_function<FunctionSignature, compact_storage>;
+    };
+
+    // Small buffer storage whose larger captures are allocated from a std::pmr::memory_resource, e.g. a per-request
+    // arena. The resource sticks to the function: assigning and reconnecting keep it, copies use the default resource
+    template<std::size_t Size = 2 * sizeof(void*), std::size_t Alignment = alignof(std::max_align_t)>
+    struct pmr_storage
+    {
+        static_assert( Size >= sizeof(void*), "Memory resource storage must be able to hold at least a pointer" );
+        static_assert( Alignment >= alignof(void*) && ( Alignment & (Alignment - 1) ) == 0, "Memory resource storage alignment must be a power of two of at least pointer alignment" );
+
+        static constexpr std::size_t size = Size;
+        static constexpr std::size_t alignment = Alignment;
+        static constexpr bool copyable = true;
+        static constexpr bool heap_fallback = true;
+        static constexpr bool uses_memory_resource = true;
+
+        template<typename FunctionSignature>
+        using container_t = _inline_function<FunctionSignature, pmr_storage>;
+    };
+
+    using default_storage = dynamic_storage;
+
+    template<typename Storage, typename = void>
+    struct _uses_memory_resource : std::false_type {};
+
+    template<typename Storage>
+    struct _uses_memory_resource<Storage, typename std::enable_if<Storage::uses_memory_resource>::type> : std::true_type {};
+
+    // Memory resource of storages allocating through one, inherited so that other storages do not pay for it
+    template<bool UsesMemoryResource>
+    struct _memory_resource_ref
+    {
+        std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
+    };
+
+    template<>
+    struct _memory_resource_ref<false> {};
+
+    // Check if a callable can be embedded in the given inline storage
+    template<typename Callable, typename Storage>
+    constexpr auto fits_inline_storage()
+    {
+        using callable_t = typename std::decay<Callable>::type;
+        return sizeof(callable_t) <= Storage::size &&
+               Storage::alignment % alignof(callable_t) == 0 &&
+               std::is_nothrow_move_constructible<callable_t>::value;
+    }
+
+    // Type-erasure core of every storage: one invoker pointer and one static table of copy, move, destroy
+    // and batch operations per callable type. Storages with a heap fallback keep a pointer to callables that do
+    // not fit, storages that are not copyable accept move-only callables. An empty core points at an invoker
+    // returning no value, so calling through invoke_result needs no emptiness check
+    template<typename Storage, typename ReturnType, typename... Args>
+    class _inline_function<ReturnType(Args...), Storage>
+        : _memory_resource_ref<_uses_memory_resource<Storage>::value>
+    {
+    public:
+
+        using result_t = typename std::conditional<is_void<ReturnType>::value, void, function_result_t<ReturnType>>::type;
+
+    private:
+
+        using invoker_t = result_t(*)( void*, Args&&... );
+
+        static constexpr bool uses_memory_resource = _uses_memory_resource<Storage>::value;
+
+        struct _vtable
+        {
+            void(*copy)( void*, const void*, std::pmr::memory_resource* );
+            void(*move)( void*, void* ) noexcept;
+            void(*destroy)( void*, std::pmr::memory_resource* ) noexcept;
+            bool(*batch)( void*, _batch_t<ReturnType, Args...>& );
+            void(*emplace)( void*, void*, Args&&... );
+        };
+
+        template<typename Callable>
+        static constexpr bool is_stored_inline = fits_inline_storage<Callable, Storage>();
+
+        // Heap fallback allocation, from the memory resource for storages using one
+        template<typename Callable, typename... CallableArgs>
+        static auto allocate( [[maybe_unused]] std::pmr::memory_resource* resource, CallableArgs&&... args ) -> Callable*
+        {
+            if constexpr( uses_memory_resource )
+            {
+                void* memory = resource->allocate( sizeof(Callable), alignof(Callable) );
+                try
+                {
+                    return ::new( memory ) Callable( std::forward<CallableArgs>(args)... );
+                }
+                catch( ... )
+                {
+                    resource->deallocate( memory, sizeof(Callable), alignof(Callable) );
+                    throw;
+                }
+            }
+            else
+            {
+                return new Callable( std::forward<CallableArgs>(args)... );
+            }
+        }
+
+        template<typename Callable>
+        static void deallocate( [[maybe_unused]] std::pmr::memory_resource* resource, Callable* callable ) noexcept
+        {
+            if constexpr( uses_memory_resource )
+            {
+                callable->~Callable();
+                resource->deallocate( callable, sizeof(Callable), alignof(Callable) );
+            }
+            else
+            {
+                delete callable;
+            }
+        }
+
+        template<typename Callable>
+        static auto access( void* buffer ) -> Callable&
+        {
+            if constexpr( is_stored_inline<Callable> )
+            {
+                return *static_cast<Callable*>( buffer );
+            }
+            else
+            {
+                return **static_cast<Callable**>( buffer );
+            }
+        }
+
+        template<typename Callable>
+        static auto invoke( void* buffer, Args&&... args ) -> result_t
+        {
+            if constexpr( is_void<ReturnType>::value )
+            {
+                std::invoke( access<Callable>(buffer), std::forward<Args>(args)... );
+            }
+            else
+            {
+                return _make_result<ReturnType>( [&]() -> decltype(auto) { return std::invoke( access<Callable>(buffer), std::forward<Args>(args)... ); } );
+            }
+        }
+
+        // Constructs a value result in the storage pointed to by result
+        template<typename Callable>
+        static void emplace( void* buffer, void* result, Args&&... args )
+        {
+            if constexpr( !is_void<ReturnType>::value )
+            {
+                _emplace_result<ReturnType>( *static_cast<result_t*>(result), [&]() -> decltype(auto) { return std::invoke( access<Callable>(buffer), std::forward<Args>(args)... ); } );
+            }
+        }
+
+        static auto invoke_empty( void*, Args&&... ) -> result_t
+        {
+            if constexpr( !is_void<ReturnType>::value )
+            {
+                return no_value;
+            }
+        }
+
+        template<typename Callable>
+        static void copy( void* target, const void* source, std::pmr::memory_resource* resource )
+        {
+            const auto& callable = access<Callable>( const_cast<void*>(source) );
+
+            if constexpr( is_stored_inline<Callable> )
+            {
+                ::new( target ) Callable( callable );
+            }
+            else
+            {
+                ::new( target ) Callable*( allocate<Callable>(resource, callable) );
+            }
+        }
+
+        template<typename Callable>
+        static void move( void* target, void* source ) noexcept
+        {
+            if constexpr( is_stored_inline<Callable> )
+            {
+                ::new( target ) Callable( std::move(access<Callable>(source)) );
+                static_cast<Callable*>(source)->~Callable();
+            }
+            else
+            {
+                ::new( target ) Callable*( *static_cast<Callable**>(source) );
+            }
+        }
+
+        template<typename Callable>
+        static void destroy( void* buffer, std::pmr::memory_resource* resource ) noexcept
+        {
+            if constexpr( is_stored_inline<Callable> )
+            {
+                static_cast<Callable*>(buffer)->~Callable();
+            }
+            else
+            {
+                deallocate( resource, *static_cast<Callable**>(buffer) );
+            }
+        }
+
+        template<typename Callable>
+        static auto batch( void* buffer, _batch_t<ReturnType, Args...>& calls ) -> bool
+        {
+            return _invoke_batch( access<Callable>(buffer), calls );
+        }
+
+        // Move-only storages never instantiate the copy operation
+        template<typename Callable>
+        static constexpr auto copier() -> void(*)( void*, const void*, std::pmr::memory_resource* )
+        {
+            if constexpr( Storage::copyable )
+            {
+                return &copy<Callable>;
+            }
+            else
+            {
+                return nullptr;
+            }
+        }
+
+        template<typename Callable>
+        static constexpr _vtable vtable_for
+        {
+            copier<Callable>(),
+            &move<Callable>,
+            &destroy<Callable>,
+            &batch<Callable>,
+            &emplace<Callable>
+        };
+
+        template<typename Callable>
+        static auto is_null( const Callable& callable ) -> bool
+        {
+            if constexpr( std::is_pointer<Callable>::value || std::is_member_pointer<Callable>::value )
+            {
+                return callable == nullptr;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        void reset() noexcept
+        {
+            if( vtable_ != nullptr )
+            {
+                vtable_->destroy( buffer_, get_memory_resource() );
+                invoker_ = &invoke_empty;
+                vtable_ = nullptr;
+            }
+        }
+
+        template<typename Function>
+        void construct( Function&& f )
+        {
+            using callable_t = typename std::decay<Function>::type;
+            static_assert( Storage::heap_fallback || is_stored_inline<callable_t>, "Function: Callable does not fit in the inline storage (too large, over-aligned or throwing move)" );
+            static_assert( !Storage::copyable || std::is_copy_constructible<callable_t>::value, "Function: Callable stored in copyable storage must be copy constructible" );
+
+            // Null function and member pointers leave the function empty, as with std::function
+            if( is_null(f) )
+            {
+                return;
+            }
+
+            if constexpr( is_stored_inline<callable_t> )
+            {
+                ::new( static_cast<void*>(buffer_) ) callable_t( std::forward<Function>(f) );
+            }
+            else
+            {
+                ::new( static_cast<void*>(buffer_) ) callable_t*( allocate<callable_t>(get_memory_resource(), std::forward<Function>(f)) );
+            }
+
+            invoker_ = &invoke<callable_t>;
+            vtable_ = &vtable_for<callable_t>;
+        }
+
+        // Copies the callable of other using this memory resource. Requires this to be empty
+        void copy_from( const _inline_function& other )
+        {
+            if( other.vtable_ != nullptr )
+            {
+                other.vtable_->copy( buffer_, other.buffer_, get_memory_resource() );
+                invoker_ = other.invoker_;
+                vtable_ = other.vtable_;
+            }
+        }
+
+        // Takes over the callable of other, allocated from the same memory resource. Requires this to be empty
+        void steal( _inline_function& other ) noexcept
+        {
+            if( other.vtable_ != nullptr )
+            {
+                other.vtable_->move( buffer_, other.buffer_ );
+                invoker_ = std::exchange( other.invoker_, &invoke_empty );
+                vtable_ = std::exchange( other.vtable_, nullptr );
+            }
+        }
+
+        auto same_memory_resource( const _inline_function& other ) const noexcept -> bool
+        {
+            return this->resource_ == other.resource_ || this->resource_->is_equal( *other.resource_ );
+        }
+
+        alignas(Storage::alignment) mutable unsigned char buffer_[Storage::size];
+        invoker_t invoker_ = &invoke_empty;
+        const _vtable* vtable_ = nullptr;
+
+    public:
+
+        _inline_function() noexcept = default;
+
+        _inline_function( std::nullptr_t ) noexcept
+        {}
+
+        template<typename Function, typename = _function_enabler<_inline_function, Function>>
+        _inline_function( Function&& f )
+        {
+            construct( std::forward<Function>(f) );
+        }
+
+        template<typename Function, typename = _function_enabler<_inline_function, Function>>
+        _inline_function( std::allocator_arg_t /*tag*/,
+                          std::pmr::memory_resource* resource,
+                          Function&& f )
+        {
+            set_memory_resource( resource );
+            construct( std::forward<Function>(f) );
+        }
+
+        // Ignores the memory resource for storages that do not use one
+        _inline_function( std::allocator_arg_t /*tag*/,
+                          [[maybe_unused]] std::pmr::memory_resource* resource,
+                          const _inline_function& other )
+        {
+            if constexpr( uses_memory_resource )
+            {
+                this->resource_ = resource;
+            }
+
+            copy_from( other );
+        }
+
+        _inline_function( const _inline_function& other )
+        {
+            copy_from( other );
+        }
+
+        _inline_function( _inline_function&& other ) noexcept
+        {
+            if constexpr( uses_memory_resource )
+            {
+                this->resource_ = other.resource_;
+            }
+
+            steal( other );
+        }
+
+        ~_inline_function()
+        {
+            reset();
+        }
+
+        auto operator=( const _inline_function& other ) -> _inline_function&
+        {
+            if( this != &other )
+            {
+                _inline_function copy( std::allocator_arg, get_memory_resource(), other );
+                reset();
+                steal( copy );
+            }
+            return *this;
+        }
+
+        // Keeps this memory resource, so callables allocated from another one are copied rather than taken over
+        auto operator=( _inline_function&& other ) noexcept( !uses_memory_resource ) -> _inline_function&
+        {
+            if( this != &other )
+            {
+                if constexpr( uses_memory_resource )
+                {
+                    if( !same_memory_resource(other) )
+                    {
+                        return *this = static_cast<const _inline_function&>( other );
+                    }
+                }
+
+                reset();
+                steal( other );
+            }
+            return *this;
+        }
+
+        // Memory resource of heap allocated callables, nullptr for storages that do not use one
+        auto get_memory_resource() const noexcept -> std::pmr::memory_resource*
+        {
+            if constexpr( uses_memory_resource )
+            {
+                return this->resource_;
+            }
+            else
+            {
+                return nullptr;
+            }
+        }
+
+        // Moves the callable to the given memory resource
+        void set_memory_resource( std::pmr::memory_resource* resource )
+        {
+            static_assert( uses_memory_resource, "Function: Storage does not use a memory resource" );
+
+            if( resource == this->resource_ )
+            {
+                return;
+            }
+
+            _inline_function moved( std::allocator_arg, resource, *this );
+            reset();
+            this->resource_ = resource;
+            steal( moved );
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return vtable_ != nullptr;
+        }
+
+        auto operator()( Args... args ) const -> ReturnType
+        {
+            if( vtable_ == nullptr )
+            {
+                throw std::bad_function_call();
+            }
+
+            if constexpr( is_void<ReturnType>::value )
+            {
+                invoker_( buffer_, std::forward<Args>(args)... );
+            }
+            else if constexpr( std::is_reference<ReturnType>::value )
+            {
+                return invoker_( buffer_, std::forward<Args>(args)... )->get();
+            }
+            else
+            {
+                return std::move( *invoker_(buffer_, std::forward<Args>(args)...) );
+            }
+        }
+
+        // Single indirect call; an empty core returns no value, or does nothing for void signatures
+        auto invoke_result( Args... args ) const -> result_t
+        {
+            return invoker_( buffer_, std::forward<Args>(args)... );
+        }
+
+        // Constructs a value result directly in the given storage, returns false if empty
+        template<typename Result>
+        auto emplace_result( Result& result, Args... args ) const -> bool
+        {
+            static_assert( std::is_same<Result, result_t>::value, "Function: Result storage does not match the function signature" );
+
+            if( vtable_ == nullptr )
+            {
+                return false;
+            }
+
+            vtable_->emplace( buffer_, &result, std::forward<Args>(args)... );
+            return true;
+        }
+
+        // Hands the whole batch to the callable if it provides invoke_batch, otherwise returns false
+        auto invoke_batch( _batch_t<ReturnType, Args...>& batch ) const -> bool
+        {
+            return vtable_ != nullptr && vtable_->batch( buffer_, batch );
+        }
+    };
+
+    // Inline function without copy operations, so that move-only callables can be stored
+    template<typename FunctionSignature, typename Storage>
+    class _move_only_function
+        : public _inline_function<FunctionSignature, Storage>
+    {
+    public:
+
+        using _inline_function<FunctionSignature, Storage>::_inline_function;
+
+        _move_only_function() noexcept = default;
+        _move_only_function( const _move_only_function& ) = delete;
+        _move_only_function( _move_only_function&& ) noexcept = default;
+        auto operator=( const _move_only_function& ) -> _move_only_function& = delete;
+        auto operator=( _move_only_function&& ) noexcept -> _move_only_function& = default;
+    };
+
+// Call policies
+
+    // Translates function_exception thrown by the callee into a missing value
+    struct exception_policy
+    {
+        static constexpr bool is_nothrow = false;
+    };
+
+    // Skips exception translation entirely; calls are noexcept, so any exception escaping the callee terminates
+    struct nothrow_policy
+    {
+        static constexpr bool is_nothrow = true;
+    };
+
+    using default_policy = exception_policy;
+
+    // How a call ended, as reported to policy probes
+    enum class call_outcome
+    {
+        value,          // The callee ran
+        missing,        // The function was empty or expired, or a function_exception was translated
+        passthrough     // An exception left the call
+    };
+
+    // Policies may define probe_t, which is constructed from the address of the called function when a call starts
+    // and receives finish( call_outcome ) when it ends. Policies without a probe are called without any extra code
+    template<typename Policy, typename = void>
+    struct _has_probe : std::false_type {};
+
+    template<typename Policy>
+    struct _has_probe<Policy, std::void_t<typename Policy::probe_t>> : std::true_type {};
+
+    // Reports value or missing from live, or passthrough if destroyed by an exception
+    template<typename Policy>
+    struct _probe_guard
+    {
+        typename Policy::probe_t probe;
+        bool live;
+        int exceptions = std::uncaught_exceptions();
+
+        explicit _probe_guard( const void* function, bool is_live = false ) noexcept
+            : probe( function ), live( is_live )
+        {
+        }
+
+        ~_probe_guard()
+        {
+            probe.finish( std::uncaught_exceptions() > exceptions ? call_outcome::passthrough
+                : live ? call_outcome::value : call_outcome::missing );
+        }
+    };
+
+    // Makes the call under the policy probe and returns its result, a bool telling whether the callee ran or the
+    // optional result of a value call. The result is returned as constructed by the call
+    template<typename Policy, typename Call>
+    auto _probe_call( const void* function, Call&& call ) noexcept( Policy::is_nothrow ) -> decltype(call())
+    {
+        _probe_guard<Policy> guard { function };
+        auto result = call();
+
+        if constexpr( std::is_same<decltype(result), bool>::value )
+        {
+            guard.live = result;
+        }
+        else
+        {
+            guard.live = result != no_value;
+        }
+
+        return result;
+    }
+
+// Call instrumentation
+
+    // Totals of an instrumented policy tag. Latency bucket i counts calls that took [2^i, 2^(i+1)) nanoseconds,
+    // bucket 0 also counts calls under one nanosecond
+    struct call_statistics
+    {
+        const char* name = nullptr;
+        std::uint64_t calls = 0;
+        std::uint64_t no_values = 0;
+        std::uint64_t passthrough_throws = 0;
+        std::array<std::uint64_t, 64> latency_histogram {};
+    };
+
+    // Process-wide list of instrumented tags, each registered on its first call
+    class instrumentation_registry
+    {
+        using collector_t = call_statistics(*)();
+
+        std::mutex mutex_;
+        std::vector<collector_t> collectors_ {};
+
+        instrumentation_registry() = default;
+
+    public:
+
+        static auto instance() -> instrumentation_registry&
+        {
+            // Leaked so that instrumented calls remain safe during static destruction
+            static auto* registry = new instrumentation_registry();
+            return *registry;
+        }
+
+        void add( collector_t collector )
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            collectors_.push_back( collector );
+        }
+
+        // Current totals of every registered tag. Counters are read while calls may update them, so a
+        // snapshot is consistent per counter but not across counters
+        auto snapshot() -> std::vector<call_statistics>
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            std::vector<call_statistics> statistics;
+            statistics.reserve( collectors_.size() );
+
+            for( const auto collector : collectors_ )
+            {
+                statistics.push_back( collector() );
+            }
+
+            return statistics;
+        }
+    };
+
+    // Per-thread counters of one tag. Only the owning thread writes them, so relaxed loads and stores suffice
+    struct alignas(64) _instrument_record
+    {
+        std::atomic<std::uint64_t> calls { 0 };
+        std::atomic<std::uint64_t> no_values { 0 };
+        std::atomic<std::uint64_t> passthrough_throws { 0 };
+        std::array<std::atomic<std::uint64_t>, 64> latency_histogram {};
+        _instrument_record* next = nullptr;
+
+        static void increment( std::atomic<std::uint64_t>& counter ) noexcept
+        {
+            counter.store( counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed );
+        }
+
+        static auto bucket( std::uint64_t nanoseconds ) noexcept -> std::size_t
+        {
+            std::size_t bucket = 0;
+            for( std::size_t shift = 32; shift > 0; shift /= 2 )
+            {
+                if( nanoseconds >> shift )
+                {
+                    nanoseconds >>= shift;
+                    bucket += shift;
+                }
+            }
+            return bucket;
+        }
+
+        void record( call_outcome outcome, std::uint64_t nanoseconds ) noexcept
+        {
+            increment( calls );
+            increment( latency_histogram[bucket(nanoseconds)] );
+
+            if( outcome == call_outcome::missing )
+            {
+                increment( no_values );
+            }
+            else if( outcome == call_outcome::passthrough )
+            {
+                increment( passthrough_throws );
+            }
+        }
+    };
+
+    // Records of all threads that called functions instrumented with the tag. Records are never freed, so totals
+    // include threads that have exited
+    template<typename Tag>
+    class _instrument_domain
+    {
+        std::atomic<_instrument_record*> records_ { nullptr };
+
+        _instrument_domain()
+        {
+            instrumentation_registry::instance().add( &collect );
+        }
+
+        static auto instance() -> _instrument_domain&
+        {
+            static auto* domain = new _instrument_domain();
+            return *domain;
+        }
+
+        auto add_record() -> _instrument_record*
+        {
+            auto* record = new _instrument_record();
+            record->next = records_.load( std::memory_order_relaxed );
+            while( !records_.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed) ) {}
+            return record;
+        }
+
+    public:
+
+        static auto local() -> _instrument_record&
+        {
+            thread_local auto* record = instance().add_record();
+            return *record;
+        }
+
+        static auto collect() -> call_statistics
+        {
+            call_statistics statistics;
+            statistics.name = Tag::name;
+
+            for( auto* record = instance().records_.load(std::memory_order_acquire); record != nullptr; record = record->next )
+            {
+                statistics.calls += record->calls.load( std::memory_order_relaxed );
+                statistics.no_values += record->no_values.load( std::memory_order_relaxed );
+                statistics.passthrough_throws += record->passthrough_throws.load( std::memory_order_relaxed );
+
+                for( std::size_t i = 0; i < statistics.latency_histogram.size(); ++i )
+                {
+                    statistics.latency_histogram[i] += record->latency_histogram[i].load( std::memory_order_relaxed );
+                }
+            }
+
+            return statistics;
+        }
+    };
+
+    template<typename Tag>
+    struct _instrument_probe
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        // Statistics are kept per tag, so the function is not recorded
+        explicit _instrument_probe( const void* ) noexcept {}
+
+        void finish( call_outcome outcome ) const noexcept
+        {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start ).count();
+            _instrument_domain<Tag>::local().record( outcome, static_cast<std::uint64_t>(elapsed > 0 ? elapsed : 0) );
+        }
+    };
+
+    // Counts calls, missing values and passthrough throws and records call latencies per tag, on top of the base
+    // policy. Tags provide a static name, e.g. struct network_tag { static constexpr const char* name = "network"; }.
+    // Defining HPP_FUNCTION_NO_INSTRUMENTATION compiles the probe out, leaving the base policy unchanged
+    template<typename Tag, typename Base = default_policy>
+    struct instrumented : Base
+    {
+#if !defined(HPP_FUNCTION_NO_INSTRUMENTATION)
+        using probe_t = _instrument_probe<Tag>;
+#endif
+
+        // Current totals of the tag, also available through instrumentation_registry
+        static auto statistics() -> call_statistics
+        {
+            return _instrument_domain<Tag>::collect();
+        }
+    };
+
+// Call tracing
+
+#if !defined(HPP_FUNCTION_TRACE_CAPACITY)
+#define HPP_FUNCTION_TRACE_CAPACITY 4096
+#endif
+
+    // Span recorded by a traced call or emission; timestamps are steady_clock nanoseconds. function is the address
+    // of the called function or of the emitting signal
+    struct trace_event
+    {
+        const char* name = nullptr;
+        const char* category = nullptr;
+        const void* function = nullptr;
+        std::uint64_t begin = 0;
+        std::uint64_t end = 0;
+        std::uint32_t thread = 0;
+    };
+
+    // Ring of the most recent spans of a thread. The owning thread is the only writer and publishes each span
+    // by advancing head_; readers drop spans that were overwritten while they copied them. Buffers of exited
+    // threads are handed to new threads, so each span keeps the index of the thread that recorded it
+    class _trace_buffer
+    {
+        static constexpr std::size_t capacity = HPP_FUNCTION_TRACE_CAPACITY;
+        static_assert( capacity > 0 && (capacity & (capacity - 1)) == 0, "Function: Trace capacity must be a power of two" );
+
+        struct slot_t
+        {
+            std::atomic<const char*> name { nullptr };
+            std::atomic<const char*> category { nullptr };
+            std::atomic<const void*> function { nullptr };
+            std::atomic<std::uint64_t> begin { 0 };
+            std::atomic<std::uint64_t> end { 0 };
+            std::atomic<std::uint32_t> thread { 0 };
+        };
+
+        std::array<slot_t, capacity> slots_ {};
+        alignas(64) std::atomic<std::uint64_t> head_ { 0 };
+        std::atomic<std::uint64_t> cleared_ { 0 };
+
+    public:
+
+        // Index of the owning thread, only accessed by that thread
+        std::uint32_t thread = 0;
+        _trace_buffer* next = nullptr;
+        _trace_buffer* next_free = nullptr;
+
+        void write( const char* name, const char* category, const void* function, std::uint64_t begin, std::uint64_t end ) noexcept
+        {
+            const auto head = head_.load( std::memory_order_relaxed );
+            auto& slot = slots_[head & (capacity - 1)];
+
+            slot.name.store( name, std::memory_order_relaxed );
+            slot.category.store( category, std::memory_order_relaxed );
+            slot.function.store( function, std::memory_order_relaxed );
+            slot.begin.store( begin, std::memory_order_relaxed );
+            slot.end.store( end, std::memory_order_relaxed );
+            slot.thread.store( thread, std::memory_order_relaxed );
+            head_.store( head + 1, std::memory_order_release );
+        }
+
+        void read( std::vector<trace_event>& events ) const
+        {
+            const auto head = head_.load( std::memory_order_acquire );
+            const auto first = std::max( cleared_.load(std::memory_order_relaxed), head > capacity ? head - capacity : 0 );
+            const auto size = events.size();
+
+            for( auto i = first; i < head; ++i )
+            {
+                const auto& slot = slots_[i & (capacity - 1)];
+                events.push_back( trace_event{ slot.name.load(std::memory_order_relaxed),
+                                               slot.category.load(std::memory_order_relaxed),
+                                               slot.function.load(std::memory_order_relaxed),
+                                               slot.begin.load(std::memory_order_relaxed),
+                                               slot.end.load(std::memory_order_relaxed),
+                                               slot.thread.load(std::memory_order_relaxed) } );
+            }
+
+            // Spans the writer reached again while they were copied, including the one it may be writing, may be torn
+            std::atomic_thread_fence( std::memory_order_acquire );
+            const auto reached = head_.load( std::memory_order_relaxed ) + 1;
+            const auto overwritten = reached > capacity ? std::min( reached - capacity, head ) : 0;
+
+            if( overwritten > first )
+            {
+                const auto torn = static_cast<std::ptrdiff_t>( overwritten - first );
+                events.erase( events.begin() + static_cast<std::ptrdiff_t>(size), events.begin() + static_cast<std::ptrdiff_t>(size) + torn );
+            }
+        }
+
+        void clear() noexcept
+        {
+            cleared_.store( head_.load(std::memory_order_acquire), std::memory_order_relaxed );
+        }
+    };
+
+    // Process-wide collection of trace buffers, one per thread that is recording spans. A thread returns its buffer
+    // when it exits and the next thread that records a span takes it over, so the number of buffers is bounded by
+    // the number of threads alive at once. Buffers are never freed, spans of exited threads remain exportable
+    // until the new owner overwrites them
+    class trace_recorder
+    {
+        std::atomic<_trace_buffer*> buffers_ { nullptr };
+        std::atomic<std::uint32_t> threads_ { 0 };
+        std::mutex free_mutex_ {};
+        _trace_buffer* free_ = nullptr;
+
+        // Returns the buffer of its thread to the recorder when the thread exits
+        struct owner_t
+        {
+            _trace_buffer* buffer = instance().acquire_buffer();
+
+            ~owner_t()
+            {
+                instance().release_buffer( std::exchange(buffer, nullptr) );
+            }
+        };
+
+        trace_recorder() = default;
+
+        auto acquire_buffer() -> _trace_buffer*
+        {
+            const auto thread = threads_.fetch_add( 1, std::memory_order_relaxed ) + 1;
+            {
+                const std::lock_guard<std::mutex> lock { free_mutex_ };
+                if( auto* buffer = free_ )
+                {
+                    free_ = std::exchange( buffer->next_free, nullptr );
+                    buffer->thread = thread;
+                    return buffer;
+                }
+            }
+
+            auto* buffer = new _trace_buffer();
+            buffer->thread = thread;
+            buffer->next = buffers_.load( std::memory_order_relaxed );
+            while( !buffers_.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed) ) {}
+            return buffer;
+        }
+
+        void release_buffer( _trace_buffer* buffer )
+        {
+            const std::lock_guard<std::mutex> lock { free_mutex_ };
+            buffer->next_free = std::exchange( free_, buffer );
+        }
+
+        static void append_escaped( std::string& out, const char* text )
+        {
+            for( ; text != nullptr && *text != '\0'; ++text )
+            {
+                if( *text == '"' || *text == '\\' )
+                {
+                    out += '\\';
+                }
+
+                if( static_cast<unsigned char>(*text) >= 0x20 )
+                {
+                    out += *text;
+                }
+            }
+        }
+
+        static void append_microseconds( std::string& out, std::uint64_t nanoseconds )
+        {
+            const auto fraction = std::to_string( 1000 + nanoseconds % 1000 );
+            out += std::to_string( nanoseconds / 1000 );
+            out += '.';
+            out.append( fraction, 1, 3 );
+        }
+
+        static void append_address( std::string& out, const void* address )
+        {
+            constexpr const char* digits = "0123456789abcdef";
+            auto value = reinterpret_cast<std::uintptr_t>( address );
+            char text[2 * sizeof(value)];
+            auto* first = std::end( text );
+
+            do
+            {
+                *--first = digits[value & 0xf];
+                value >>= 4;
+            }
+            while( value != 0 );
+
+            out += "0x";
+            out.append( first, std::end(text) );
+        }
+
+    public:
+
+        static auto instance() -> trace_recorder&
+        {
+            static auto* recorder = new trace_recorder();
+            return *recorder;
+        }
+
+        // Buffer of the calling thread, null once the thread returned it while running thread local destructors
+        static auto local() -> _trace_buffer*
+        {
+            thread_local owner_t owner;
+            return owner.buffer;
+        }
+
+        static auto now() noexcept -> std::uint64_t
+        {
+            return static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count() );
+        }
+
+        // Retained spans of all threads ordered by begin time
+        auto events() const -> std::vector<trace_event>
+        {
+            std::vector<trace_event> events;
+
+            for( auto* buffer = buffers_.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next )
+            {
+                buffer->read( events );
+            }
+
+            std::sort( events.begin(), events.end(), []( const trace_event& lhs, const trace_event& rhs )
+            {
+                return lhs.begin < rhs.begin;
+            } );
+
+            return events;
+        }
+
+        // Drops the spans recorded so far on every thread
+        void clear() noexcept
+        {
+            for( auto* buffer = buffers_.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next )
+            {
+                buffer->clear();
+            }
+        }
+
+        // Retained spans as Chrome trace event JSON, loadable by chrome://tracing and Perfetto
+        auto chrome_trace_json() const -> std::string
+        {
+            const auto spans = events();
+            std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+            for( std::size_t i = 0; i < spans.size(); ++i )
+            {
+                const auto& span = spans[i];
+                json += i == 0 ? "{\"name\":\"" : ",{\"name\":\"";
+                append_escaped( json, span.name );
+                json += "\",\"cat\":\"";
+                append_escaped( json, span.category );
+                json += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+                json += std::to_string( span.thread );
+                json += ",\"ts\":";
+                append_microseconds( json, span.begin );
+                json += ",\"dur\":";
+                append_microseconds( json, span.end > span.begin ? span.end - span.begin : 0 );
+                json += ",\"args\":{\"function\":\"";
+                append_address( json, span.function );
+                json += "\"}}";
+            }
+
+            json += "]}";
+            return json;
+        }
+    };
+
+    // Records one of every SampleEvery spans per thread; unsampled calls only decrement a thread local counter
+    template<typename Tag, std::size_t SampleEvery, bool Emission = false>
+    class _trace_probe
+    {
+        static_assert( SampleEvery > 0, "Function: Trace sampling interval must be positive" );
+
+        const void* function_;
+        std::uint64_t begin_;
+
+        static auto sampled() noexcept -> bool
+        {
+            if constexpr( SampleEvery == 1 )
+            {
+                return true;
+            }
+            else
+            {
+                thread_local std::size_t countdown = 1;
+
+                if( --countdown != 0 )
+                {
+                    return false;
+                }
+
+                countdown = SampleEvery;
+                return true;
+            }
+        }
+
+    public:
+
+        explicit _trace_probe( const void* function ) noexcept
+            : function_( function ), begin_( sampled() ? trace_recorder::now() : 0 )
+        {
+        }
+
+        void finish( call_outcome ) const noexcept
+        {
+            if( begin_ == 0 )
+            {
+                return;
+            }
+
+            if( auto* buffer = trace_recorder::local() )
+            {
+                buffer->write( Tag::name, Emission ? "emit" : "call", function_, begin_, trace_recorder::now() );
+            }
+        }
+    };
+
+    // Records call spans into the calling thread's trace buffer, named after Tag::name and carrying the address of
+    // the called function. Signals using the policy also record a span per emission, carrying the address of the
+    // signal. Defining HPP_FUNCTION_NO_TRACING compiles the probes out
+    template<typename Tag, std::size_t SampleEvery = 1, typename Base = default_policy>
+    struct traced : Base
+    {
+#if !defined(HPP_FUNCTION_NO_TRACING)
+        using probe_t = _trace_probe<Tag, SampleEvery>;
+        using emission_probe_t = _trace_probe<Tag, SampleEvery, true>;
+#endif
+    };
+
+// Function definition
+
+    template<typename Container, typename = void>
+    struct _invokes_result : std::false_type {};
+
+    // Storages may pick a sentinel representation through sentinel_handle_t, the default is sentinel_opt_t
+    template<typename Storage, typename = void>
+    struct _sentinel_handle
+    {
+        using type = sentinel_opt_t;
+    };
+
+    template<typename Storage>
+    struct _sentinel_handle<Storage, std::void_t<typename Storage::sentinel_handle_t>>
+    {
+        using type = typename Storage::sentinel_handle_t;
+    };
+
+    template<typename Container>
+    struct _invokes_result<Container, std::void_t<decltype(&Container::invoke_result)>> : std::true_type {};
+
+    // Basic function methods
+    template<typename FunctionSignature, typename Storage>
+    struct _function_container
+    {
+        using func_t = typename Storage::template container_t<FunctionSignature>;
+
+    // Utilities
+
+        void disconnect() const
+        {
+            slot_ = {};
+        }
+
+        auto empty() const -> bool
+        {
+            return !slot_.func;
+        }
+
+        auto expired() const -> bool
+        {
+            return _sentinel_expired( slot_.sentinel );
+        }
+
+        auto valid() const -> bool
+        {
+            return !expired() && !empty();
+        }
+
+        operator bool() const
+        {
+            return valid();
+        }
+
+        // Memory resource backing large captures of storages such as pmr_storage; kept when reconnecting
+        void set_memory_resource( std::pmr::memory_resource* resource )
+        {
+            slot_.func.set_memory_resource( resource );
+        }
+
+        auto get_memory_resource() const -> std::pmr::memory_resource*
+        {
+            return slot_.func.get_memory_resource();
+        }
+
+    protected:
+
+        // To be held while checking validity and making the call
+        auto pin() const -> _sentinel_pin
+        {
+            return _sentinel_pin( _sentinel_synchronized(slot_.sentinel) );
+        }
+
+        // Calls the stored callable unless the function is expired or empty. Containers whose empty state
+        // invokes to no value are called without checking for emptiness
+        template<typename ReturnType, typename... FunctionArgs>
+        auto call_slot( FunctionArgs&&... args ) const -> typename std::conditional<is_void<ReturnType>::value, void, function_result_t<ReturnType>>::type
+        {
+            if constexpr( _invokes_result<func_t>::value )
+            {
+                if( !expired() )
+                {
+                    return slot_.func.invoke_result( std::forward<FunctionArgs>(args)... );
+                }
+            }
+            else if( valid() )
+            {
+                if constexpr( is_void<ReturnType>::value )
+                {
+                    slot_.func( std::forward<FunctionArgs>(args)... );
+                }
+                else
+                {
+                    return _make_result<ReturnType>( [&]() -> decltype(auto) { return slot_.func( std::forward<FunctionArgs>(args)... ); } );
+                }
+            }
+
+            if constexpr( !is_void<ReturnType>::value )
+            {
+                return no_value;
+            }
+        }
+
+        // Constructs the result of the stored callable in the given storage, returns false if there was no call
+        template<typename ReturnType, typename... FunctionArgs>
+        auto emplace_slot( function_result_t<ReturnType>& result, FunctionArgs&&... args ) const -> bool
+        {
+            if constexpr( _invokes_result<func_t>::value )
+            {
+                if( !expired() )
+                {
+                    return slot_.func.emplace_result( result, std::forward<FunctionArgs>(args)... );
+                }
+            }
+            else if( valid() )
+            {
+                _emplace_result<ReturnType>( result, [&]() -> decltype(auto) { return slot_.func( std::forward<FunctionArgs>(args)... ); } );
+                return true;
+            }
+
+            return false;
+        }
+
+        template<typename... FunctionArgs>
+        void connect_impl( const sentinel_opt_t& sentinel, FunctionArgs&&... args )
+        {
+            // Converted first, so that a sentinel the storage rejects leaves the function unchanged
+            typename _sentinel_handle<Storage>::type handle = sentinel;
+
+            if constexpr( _uses_memory_resource<Storage>::value )
+            {
+                slot_.func = func_t( std::allocator_arg, slot_.func.get_memory_resource(), std::forward<FunctionArgs>(args)... );
+            }
+            else
+            {
+                slot_.func = { std::forward<FunctionArgs>(args)... };
+            }
+
+            slot_.sentinel = std::move( handle );
+        }
+
+        mutable struct
+        {
+            func_t func {};
+            typename _sentinel_handle<Storage>::type sentinel {};
+        } slot_;
+    };
+
+    // Function call method specializations
+    template<typename Storage, typename Policy, typename... Args>
+    struct _void_function_base
+        : _function_container<void(Args...), Storage>
+    {
+        template<typename... FunctionArgs>
+        void operator()( FunctionArgs&&... args ) const noexcept( Policy::is_nothrow )
+        {
+            call( std::forward<FunctionArgs>(args)... );
+        }
+
+        void operator()( Args&&... args ) const noexcept( Policy::is_nothrow )
+        {
+            call( std::move(args)... );
+        }
+
+        // Calls the function and returns whether the callee ran without a function_exception being translated,
+        // false also when the function was empty or expired
+        template<typename... FunctionArgs>
+        auto try_call( FunctionArgs&&... args ) const noexcept( Policy::is_nothrow ) -> bool
+        {
+            const auto live = this->valid();
+            if constexpr( _has_probe<Policy>::value )
+            {
+                return _probe_call<Policy>( this, [&]{ return call_direct( std::forward<FunctionArgs>(args)... ) && live; } );
+            }
+            else
+            {
+                return call_direct( std::forward<FunctionArgs>(args)... ) && live;
+            }
+        }
+
+        using input_t = typename _batch_input<Args...>::type;
+
+        // Calls the function for every input with a single validity check for the whole batch. Callables that
+        // provide invoke_batch( inputs ) receive the whole range at once so they can vectorize internally
+        void invoke_batch( span<const input_t> inputs ) const noexcept( Policy::is_nothrow )
+        {
+            const auto pin = this->pin();
+            if( !this->valid() )
+            {
+                return;
+            }
+
+            _batch_t<void, Args...> batch { inputs };
+            guarded( [&]{ forward_batch( batch ); } );
+        }
+
+    private:
+
+        template<typename Call>
+        void guarded( Call&& call ) const noexcept( Policy::is_nothrow )
+        {
+            if constexpr( Policy::is_nothrow )
+            {
+                call();
+            }
+            else
+            {
+                try
+                {
+                    call();
+                }
+                catch( const function_exception& e )
+                {
+                    if( e.is_passthrough() )
+                    {
+                        throw;
+                    }
+                }
+            }
+        }
+
+        void forward_batch( _batch_t<void, Args...>& batch ) const noexcept( Policy::is_nothrow )
+        {
+            using func_t = typename _void_function_base::func_t;
+
+            if constexpr( _storage_accepts_batch<func_t, _batch_t<void, Args...>>::value )
+            {
+                if( this->slot_.func.invoke_batch(batch) )
+                {
+                    return;
+                }
+            }
+
+            for( const auto& input : batch.inputs )
+            {
+                guarded( [&]
+                {
+                    if constexpr( sizeof...(Args) == 1 )
+                    {
+                        this->slot_.func( input );
+                    }
+                    else
+                    {
+                        std::apply( this->slot_.func, input );
+                    }
+                } );
+            }
+        }
+
+        template<typename... FunctionArgs>
+        void call( FunctionArgs&&... args ) const noexcept( Policy::is_nothrow )
+        {
+            if constexpr( _has_probe<Policy>::value )
+            {
+                try_call( std::forward<FunctionArgs>(args)... );
+            }
+            else
+            {
+                call_direct( std::forward<FunctionArgs>(args)... );
+            }
+        }
+
+        // Returns false if the call threw a non-passthrough function_exception
+        template<typename... FunctionArgs>
+        auto call_direct( FunctionArgs&&... args ) const noexcept( Policy::is_nothrow ) -> bool
+        {
+            if constexpr( Policy::is_nothrow )
+            {
+                const auto pin = this->pin();
+                this->template call_slot<void>( std::forward<FunctionArgs>(args)... );
+            }
+            else
+            {
+                try
+                {
+                    const auto pin = this->pin();
+                    this->template call_slot<void>( std::forward<FunctionArgs>(args)... );
+                }
+                catch( const function_exception& e )
+                {
+                    if( e.is_passthrough() )
+                    {
+                        throw;
+                    }
+
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+
+    template<typename Storage, typename Policy, typename ReturnType, typename... Args>
+    struct _value_function_base
+        : _function_container<ReturnType(Args...), Storage>
+    {
+        using return_t = function_result_t<ReturnType>;
+
+        template<typename... FunctionArgs>
+        auto operator()( FunctionArgs&&... args ) const noexcept( Policy::is_nothrow ) -> return_t
+        {
+            return call( std::forward<FunctionArgs>(args)... );
+        }
+
+        auto operator()( Args&&... args ) const noexcept( Policy::is_nothrow ) -> return_t
+        {
+            return call( std::move(args)... );
+        }
+
+        // Constructs the result directly in the given storage instead of returning it, so large results are neither
+        // copied nor moved. Returns false and leaves the storage empty when the call produced no value
+        template<typename... FunctionArgs>
+        auto invoke_into( return_t& result,
+                          FunctionArgs&&... args ) const noexcept( Policy::is_nothrow ) -> bool
+        {
+            result.reset();
+
+            const auto pin = this->pin();
+            bool called = false;
+            const auto completed = guarded( [&]
+            {
+                called = this->template emplace_slot<ReturnType>( result, std::forward<FunctionArgs>(args)... );
+            } );
+
+            return completed && called;
+        }
+
+        using input_t = typename _batch_input<Args...>::type;
+
+        // Calls the function for every input and stores the results to the matching outputs, with a single
+        // validity check for the whole batch; processes as many inputs as there are outputs. Callables that
+        // provide invoke_batch( inputs, outputs ) receive the whole range at once so they can vectorize internally
+        void invoke_batch( span<const input_t> inputs,
+                           span<return_t> outputs ) const noexcept( Policy::is_nothrow )
+        {
+            _batch_t<ReturnType, Args...> batch { { inputs.data(), std::min(inputs.size(), outputs.size()) }, outputs };
+
+            const auto pin = this->pin();
+            if( !this->valid() )
+            {
+                std::fill_n( outputs.begin(), batch.inputs.size(), no_value );
+                return;
+            }
+
+            if( !guarded( [&]{ forward_batch( batch ); } ) )
+            {
+                std::fill_n( outputs.begin(), batch.inputs.size(), no_value );
+            }
+        }
+
+    private:
+
+        // Returns false if the call threw a non-passthrough function_exception
+        template<typename Call>
+        auto guarded( Call&& call ) const noexcept( Policy::is_nothrow ) -> bool
+        {
+            if constexpr( Policy::is_nothrow )
+            {
+                call();
+            }
+            else
+            {
+                try
+                {
+                    call();
+                }
+                catch( const function_exception& e )
+                {
+                    if( e.is_passthrough() )
+                    {
+                        throw;
+                    }
+
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        void forward_batch( _batch_t<ReturnType, Args...>& batch ) const noexcept( Policy::is_nothrow )
+        {
+            using func_t = typename _value_function_base::func_t;
+
+            if constexpr( _storage_accepts_batch<func_t, _batch_t<ReturnType, Args...>>::value )
+            {
+                if( this->slot_.func.invoke_batch(batch) )
+                {
+                    return;
+                }
+            }
+
+            for( std::size_t i = 0; i < batch.inputs.size(); ++i )
+            {
+                auto& output = batch.outputs[i];
+                const auto& input = batch.inputs[i];
+
+                if( !guarded( [&]
+                    {
+                        if constexpr( sizeof...(Args) == 1 )
+                        {
+                            _emplace_result<ReturnType>( output, [&]() -> decltype(auto) { return this->slot_.func( input ); } );
+                        }
+                        else
+                        {
+                            _emplace_result<ReturnType>( output, [&]() -> decltype(auto) { return std::apply( this->slot_.func, input ); } );
+                        }
+                    } ) )
+                {
+                    output = no_value;
+                }
+            }
+        }
+
+        template<typename... FunctionArgs>
+        auto call( FunctionArgs&&... args ) const noexcept( Policy::is_nothrow ) -> return_t
+        {
+            if constexpr( _has_probe<Policy>::value && !std::is_move_constructible<return_t>::value )
+            {
+                // The result can only be returned as a prvalue, so the outcome is taken from the function state
+                const _probe_guard<Policy> guard { this, this->valid() };
+                return call_direct( std::forward<FunctionArgs>(args)... );
+            }
+            else if constexpr( _has_probe<Policy>::value )
+            {
+                return _probe_call<Policy>( this, [&]{ return call_direct( std::forward<FunctionArgs>(args)... ); } );
+            }
+            else
+            {
+                return call_direct( std::forward<FunctionArgs>(args)... );
+            }
+        }
+
+        template<typename... FunctionArgs>
+        auto call_direct( FunctionArgs&&... args ) const noexcept( Policy::is_nothrow ) -> return_t
+        {
+            if constexpr( Policy::is_nothrow )
+            {
+                const auto pin = this->pin();
+                return this->template call_slot<ReturnType>( std::forward<FunctionArgs>(args)... );
+            }
+            else
+            {
+                try
+                {
+                    const auto pin = this->pin();
+                    return this->template call_slot<ReturnType>( std::forward<FunctionArgs>(args)... );
+                }
+                catch( const function_exception& e )
+                {
+                    if( e.is_passthrough() )
+                    {
+                        throw;
+                    }
+                }
+            }
+
+            return no_value;
+        }
+    };
+
+    // Template base
+    template<typename Function, typename Storage = default_storage, typename Policy = default_policy, typename Enabler = void>
+    struct function;
+
+    // Function without exception translation, suitable for inlining into tight loops
+    template<typename Function, typename Storage = default_storage>
+    using nothrow_function = function<Function, Storage, nothrow_policy>;
+
+    // Function accepting move-only callables; moves never allocate and never throw
+    template<typename Function, typename Policy = default_policy>
+    using move_only_function = function<Function, move_only_storage<>, Policy>;
+
+    // Function of at most one cache line, see compact_storage
+    template<typename Function, typename Policy = default_policy>
+    using compact_function = function<Function, compact_storage<>, Policy>;
+
+// Void functions
+
+    // Generic void function
+    template<typename Storage, typename Policy, typename ReturnType, typename... Args>
+    struct function<ReturnType(Args...), Storage, Policy, returns_void<ReturnType>>
+        : _void_function_base<Storage, Policy, Args...>
+    {
+        template<class Class>
+        using mem_func_t = void(Class::*const)(Args...);
+
+        template<class Class>
+        using const_mem_func_t = void(Class::*const)(Args...) const;
+
+        template<class Class>
+        void connect( const sentinel_opt_t& sentinel,
+                      Class* const object_ptr,
+                      const mem_func_t<Class>& method_ptr )
+        {
+            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args) -> decltype(auto) { return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
+        }
+
+        template<class Class>
+        void connect( const sentinel_opt_t& sentinel,
+                      const Class* const object_ptr,
+                      const const_mem_func_t<Class>& method_ptr )
+        {
+            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args) -> decltype(auto) { return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
+        }
+
+        template<auto Method, class Class>
+        void connect( const sentinel_opt_t& sentinel,
+                      Class* const object_ptr )
+        {
+            static_assert( std::is_invocable_r<ReturnType, decltype(Method), Class*, Args...>::value, "Function: Member function does not match the function signature" );
+            this->connect_impl( sentinel, [object_ptr](auto&&... args) -> decltype(auto) { return (object_ptr->*Method)(std::forward<Args>(args)...); } );
+        }
+
+        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<function, Function, Sentinel>>
+        void connect( const Sentinel& sentinel,
+                      Function&& f )
+        {
+            this->connect_impl( sentinel, std::forward<Function>(f) );
+        }
+
+        template<class Class>
+        void connect( Class* const object_ptr,
+                      const mem_func_t<Class>& method_ptr )
+        {
+            connect( no_value, object_ptr, method_ptr );
+        }
+
+        template<class Class>
+        void connect( const Class* const object_ptr,
+                      const const_mem_func_t<Class>& method_ptr )
+        {
+            connect( no_value, object_ptr, method_ptr );
+        }
+
+        template<auto Method, class Class>
+        void connect( Class* const object_ptr )
+        {
+            connect<Method>( no_value, object_ptr );
+        }
+
+        template<typename Function, typename = _function_enabler<function, Function>>
+        void connect( Function&& f )
+        {
+            connect( no_value, std::forward<Function>(f) );
+        }
+
+        template<typename Executor, typename Function, typename = _executor_enabler<Executor>, typename = _function_enabler<function, Function>>
+        void connect( Executor& executor,
+                      const sentinel_opt_t& sentinel,
+                      Function&& f )
+        {
+            using callable_t = typename std::decay<Function>::type;
+            this->connect_impl( sentinel, _executor_bound<Executor, callable_t, Args...>(executor, std::make_shared<callable_t>(std::forward<Function>(f)), sentinel) );
+        }
+
+        template<typename Executor, typename Function, typename = _executor_enabler<Executor>, typename = _function_enabler<function, Function>>
+        void connect( Executor& executor,
+                      Function&& f )
+        {
+            connect( executor, no_value, std::forward<Function>(f) );
+        }
+
+        template<typename Function, typename = _function_enabler<function, Function>>
+        auto operator=( Function&& f ) -> function&
+        {
+            connect( _sentinel_value(this->slot_.sentinel), std::forward<Function>(f) );
+            return *this;
+        }
+
+        function() = default;
+
+        template<class Class>
+        function( const sentinel_opt_t& sentinel,
+                  Class* const object_ptr,
+                  const mem_func_t<Class>& method_ptr )
+        {
+            connect( sentinel, object_ptr, method_ptr );
+        }
+
+        template<class Class>
+        function( const sentinel_opt_t& sentinel,
+                  const Class* const object_ptr,
+                  const const_mem_func_t<Class>& method_ptr )
+        {
+            connect( sentinel, object_ptr, method_ptr );
+        }
+
+        template<auto Method, class Class>
+        function( const sentinel_opt_t& sentinel,
+                  nontype_t<Method> /*method*/,
+                  Class* const object_ptr )
+        {
+            connect<Method>( sentinel, object_ptr );
+        }
+
+        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<function, Function, Sentinel>>
+        function( const Sentinel& sentinel,
+                  Function&& f )
+        {
+           connect( sentinel, std::forward<Function>(f) );
+        }
+
+        template<class Class>
+        function( Class* const object_ptr,
+                  const mem_func_t<Class>& method_ptr )
+        {
+           connect( no_value, object_ptr, method_ptr );
+        }
+
+        template<class Class>
+        function( const Class* const object_ptr,
+                  const const_mem_func_t<Class>& method_ptr )
+        {
+           connect( no_value, object_ptr, method_ptr );
+        }
+
+        template<auto Method, class Class>
+        function( nontype_t<Method> /*method*/,
+                  Class* const object_ptr )
+        {
+            connect<Method>( no_value, object_ptr );
+        }
+
+        template<typename Function, typename = _function_enabler<function, Function>>
+        function( Function&& f )
+        {
+           connect( no_value, std::forward<Function>(f) );
+        }
+    };
+
+    // Void function reference
+    template<typename Storage, typename Policy, typename ReturnType, typename... Args>
+    struct function<ReturnType(*)(Args...), Storage, Policy, returns_void<ReturnType>>
+        : _void_function_base<Storage, Policy, Args...>
+    {
+
+        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<function, Function, Sentinel>>
+        void connect( const Sentinel& sentinel,
+                      Function&& f )
+        {
+            this->connect_impl( sentinel, std::forward<Function>(f) );
+        }
+
+        template<typename Function, typename = _function_enabler<function, Function>>
+        void connect( Function&& f )
+        {
+            connect( no_value, std::forward<Function>(f) );
+        }
+
+        function() = default;
+
+        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<function, Function, Sentinel>>
+        function( const Sentinel& sentinel,
+                  Function&& f )
+        {
+            connect( sentinel, std::forward<Function>(f) );
+        }
+
+        template<typename Function, typename = _function_enabler<function, Function>>
+        function( Function&& f )
+        {
+            connect( no_value, std::forward<Function>(f) );
+        }
+    };
+
+    // Member void function reference
+    template<typename Storage, typename Policy, typename ReturnType, typename Class, typename... Args>
+    struct function<ReturnType(Class::*)(Args...), Storage, Policy, returns_void<ReturnType>>
+        : _void_function_base<Storage, Policy, Args...>
+    {
+        using mem_func_t = void(Class::*const)(Args...);
+
+        void connect( const sentinel_opt_t& sentinel,
+                      Class* const object_ptr,
+                      const mem_func_t& method_ptr )
+        {
+            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args) -> decltype(auto) { return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
+        }
+
+        void connect( Class* const object_ptr,
+                      const mem_func_t& method_ptr )
+        {
+            connect( no_value, object_ptr, method_ptr );
+        }
+
+        function() = default;
+
+        function( const sentinel_opt_t& sentinel,
+                  Class* const object_ptr,
+                  const mem_func_t& method_ptr )
+        {
+            connect( sentinel, object_ptr, method_ptr );
         }
 
-        mutable struct
+        function( Class* const object_ptr,
+                  const mem_func_t& method_ptr )
         {
-            func_t func {};
-            sentinel_opt_t sentinel {};
-        } slot_;
+            connect( no_value, object_ptr, method_ptr );
+        }
     };
 
-    // Function call method specializations
-    template<typename... Args>
-    struct _void_function_base
-        : _function_container<void(Args...)>
+    // Member const void function reference
+    template<typename Storage, typename Policy, typename ReturnType, typename Class, typename... Args>
+    struct function<ReturnType(Class::*)(Args...) const, Storage, Policy, returns_void<ReturnType>>
+        : _void_function_base<Storage, Policy, Args...>
     {
-        template<typename... FunctionArgs>
-        void operator()( FunctionArgs&&... args ) const
+        using const_mem_func_t = void(Class::*const)(Args...) const;
+
+        void connect( const sentinel_opt_t& sentinel,
+                      const Class* const object_ptr,
+                      const const_mem_func_t& method_ptr )
         {
-            try
-            {
-                if( this->valid() )
-                {
-                    this->slot_.func( std::forward<FunctionArgs>(args)... );
-                }
-            }
-            catch( const function_exception& e )
-            {
-                if( e.is_passthrough() )
-                {
-                    throw;
-                }
-            }
+            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args) -> decltype(auto) { return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
         }
 
-        void operator()( Args&&... args ) const
+        void connect( const Class* const object_ptr,
+                      const const_mem_func_t& method_ptr )
         {
-            try
-            {
-                if( this->valid() )
-                {
-                    this->slot_.func( std::move(args)... );
-                }
-            }
-            catch( const function_exception& e )
-            {
-                if( e.is_passthrough() )
-                {
-                    throw;
-                }
-            }
+            connect( no_value, object_ptr, method_ptr );
         }
-    };
 
-    template<typename ReturnType, typename... Args>
-    struct _value_function_base
-        : _function_container<ReturnType(Args...)>
-    {
-        static_assert( !std::is_reference<ReturnType>::value, "Function return type cannot be a reference" );
-        using return_t = optional<ReturnType>;
+        function() = default;
 
-        template<typename... FunctionArgs>
-        auto operator()( FunctionArgs&&... args ) const -> return_t
+        function( const sentinel_opt_t& sentinel,
+                  const Class* const object_ptr,
+                  const const_mem_func_t& method_ptr )
         {
-            try
-            {
-                if( this->valid() )
-                {
-                    return return_t{ this->slot_.func(std::forward<FunctionArgs>(args)...) };
-                }
-            }
-            catch( const function_exception& e )
-            {
-                if( e.is_passthrough() )
-                {
-                    throw;
-                }
-            }
-
-            return no_value;
+            connect( sentinel, object_ptr, method_ptr );
         }
 
-        auto operator()( Args&&... args ) const -> return_t
+        function( const Class* const object_ptr,
+                  const const_mem_func_t& method_ptr )
         {
-            try
-            {
-                if( this->valid() )
-                {
-                    return return_t{ this->slot_.func(std::move(args)...) };
-                }
-            }
-            catch( const function_exception& e )
-            {
-                if( e.is_passthrough() )
-                {
-                    throw;
-                }
-            }
-
-            return no_value;
+            connect( no_value, object_ptr, method_ptr );
         }
     };
 
-    // Template base
-    template<typename Function, typename Enabler = void>
-    struct function;
-
-// Void functions
+// Value functions
 
-    // Generic void function
-    template<typename ReturnType, typename... Args>
-    struct function<ReturnType(Args...), returns_void<ReturnType>>
-        : _void_function_base<Args...>
+    // Generic function
+    template<typename Storage, typename Policy, typename ReturnType, typename... Args>
+    struct function<ReturnType(Args...), Storage, Policy, returns_value<ReturnType>>
+        : _value_function_base<Storage, Policy, ReturnType, Args...>
     {
         template<class Class>
-        using mem_func_t = void(Class::*const)(Args...);
+        using mem_func_t = ReturnType(Class::*const)(Args...);
 
         template<class Class>
-        using const_mem_func_t = void(Class::*const)(Args...) const;
+        using const_mem_func_t = ReturnType(Class::*const)(Args...) const;
 
         template<class Class>
         void connect( const sentinel_opt_t& sentinel,
                       Class* const object_ptr,
                       const mem_func_t<Class>& method_ptr )
         {
-            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args){ return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
+            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args) -> decltype(auto) { return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
         }
 
         template<class Class>
@@ -327,7 +3208,15 @@ namespace hpp
                       const Class* const object_ptr,
                       const const_mem_func_t<Class>& method_ptr )
         {
-            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args){ return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
+            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args) -> decltype(auto) { return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
+        }
+
+        template<auto Method, class Class>
+        void connect( const sentinel_opt_t& sentinel,
+                      Class* const object_ptr )
+        {
+            static_assert( std::is_invocable_r<ReturnType, decltype(Method), Class*, Args...>::value, "Function: Member function does not match the function signature" );
+            this->connect_impl( sentinel, [object_ptr](auto&&... args) -> decltype(auto) { return (object_ptr->*Method)(std::forward<Args>(args)...); } );
         }
 
         template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<function, Function, Sentinel>>
@@ -351,6 +3240,12 @@ namespace hpp
             connect( no_value, object_ptr, method_ptr );
         }
 
+        template<auto Method, class Class>
+        void connect( Class* const object_ptr )
+        {
+            connect<Method>( no_value, object_ptr );
+        }
+
         template<typename Function, typename = _function_enabler<function, Function>>
         void connect( Function&& f )
         {
@@ -360,7 +3255,7 @@ namespace hpp
         template<typename Function, typename = _function_enabler<function, Function>>
         auto operator=( Function&& f ) -> function&
         {
-            connect( this->slot_.sentinel, std::forward<Function>(f) );
+            connect( _sentinel_value(this->slot_.sentinel), std::forward<Function>(f) );
             return *this;
         }
 
@@ -382,40 +3277,54 @@ namespace hpp
             connect( sentinel, object_ptr, method_ptr );
         }
 
+        template<auto Method, class Class>
+        function( const sentinel_opt_t& sentinel,
+                  nontype_t<Method> /*method*/,
+                  Class* const object_ptr )
+        {
+            connect<Method>( sentinel, object_ptr );
+        }
+
         template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<function, Function, Sentinel>>
         function( const Sentinel& sentinel,
                   Function&& f )
         {
-           connect( sentinel, std::forward<Function>(f) );
+            connect( sentinel, std::forward<Function>(f) );
         }
 
         template<class Class>
         function( Class* const object_ptr,
                   const mem_func_t<Class>& method_ptr )
         {
-           connect( no_value, object_ptr, method_ptr );
+            connect( no_value, object_ptr, method_ptr );
         }
 
         template<class Class>
         function( const Class* const object_ptr,
                   const const_mem_func_t<Class>& method_ptr )
         {
-           connect( no_value, object_ptr, method_ptr );
+            connect( no_value, object_ptr, method_ptr );
+        }
+
+        template<auto Method, class Class>
+        function( nontype_t<Method> /*method*/,
+                  Class* const object_ptr )
+        {
+            connect<Method>( no_value, object_ptr );
         }
 
         template<typename Function, typename = _function_enabler<function, Function>>
         function( Function&& f )
         {
-           connect( no_value, std::forward<Function>(f) );
+            connect( no_value, std::forward<Function>(f) );
         }
     };
 
-    // Void function reference
-    template<typename ReturnType, typename... Args>
-    struct function<ReturnType(*)(Args...), returns_void<ReturnType>>
-        : _void_function_base<Args...>
+    // Function reference
+    template<typename Storage, typename Policy, typename ReturnType, typename... Args>
+    struct function<ReturnType(*)(Args...), Storage, Policy, returns_value<ReturnType>>
+        : _value_function_base<Storage, Policy, ReturnType, Args...>
     {
-
         template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<function, Function, Sentinel>>
         void connect( const Sentinel& sentinel,
                       Function&& f )
@@ -445,18 +3354,18 @@ namespace hpp
         }
     };
 
-    // Member void function reference
-    template<typename ReturnType, typename Class, typename... Args>
-    struct function<ReturnType(Class::*)(Args...), returns_void<ReturnType>>
-        : _void_function_base<Args...>
+    // Member function reference
+    template<typename Storage, typename Policy, typename ReturnType, typename Class, typename... Args>
+    struct function<ReturnType(Class::*)(Args...), Storage, Policy, returns_value<ReturnType>>
+        : _value_function_base<Storage, Policy, ReturnType, Args...>
     {
-        using mem_func_t = void(Class::*const)(Args...);
+        using mem_func_t = ReturnType(Class::*)(Args...);
 
         void connect( const sentinel_opt_t& sentinel,
                       Class* const object_ptr,
                       const mem_func_t& method_ptr )
         {
-            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args){ return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
+            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args) -> decltype(auto) { return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
         }
 
         void connect( Class* const object_ptr,
@@ -481,18 +3390,18 @@ namespace hpp
         }
     };
 
-    // Member const void function reference
-    template<typename ReturnType, typename Class, typename... Args>
-    struct function<ReturnType(Class::*)(Args...) const, returns_void<ReturnType>>
-        : _void_function_base<Args...>
+    // Member const function reference
+    template<typename Storage, typename Policy, typename ReturnType, typename Class, typename... Args>
+    struct function<ReturnType(Class::*)(Args...) const, Storage, Policy, returns_value<ReturnType>>
+        : _value_function_base<Storage, Policy, ReturnType, Args...>
     {
-        using const_mem_func_t = void(Class::*const)(Args...) const;
+        using const_mem_func_t = ReturnType(Class::*const)(Args...) const;
 
         void connect( const sentinel_opt_t& sentinel,
                       const Class* const object_ptr,
                       const const_mem_func_t& method_ptr )
         {
-            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args){ return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
+            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args) -> decltype(auto) { return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
         }
 
         void connect( const Class* const object_ptr,
@@ -517,324 +3426,627 @@ namespace hpp
         }
     };
 
-// Value functions
+// Size guarantees
 
-    // Generic function
+    struct _size_probe
+    {
+        void method();
+    };
+
+    // Member function bindings, an object pointer plus a member pointer, stay in the compact buffer
+    static_assert( compact_storage<>::size >= sizeof(_size_probe*) + sizeof(&_size_probe::method),
+                   "Function: Member function bindings must fit compact storage" );
+
+    static_assert( sizeof(compact_function<void()>) <= 64 && sizeof(compact_function<int(int)>) <= 64 &&
+                   sizeof(compact_function<void(_size_probe&, int, double)>) <= 64,
+                   "Function: Compact functions must fit a 64 byte cache line" );
+
+    static_assert( alignof(compact_function<void()>) <= alignof(void*),
+                   "Function: Compact functions must pack densely in arrays" );
+    
+// Non-owning function view
+
+    template<typename FunctionSignature>
+    class function_ref;
+
+    // Trivially copyable two-pointer callable view for hot call paths. Does not own or
+    // copy the callable, which must outlive the view; calls do not check any sentinel
     template<typename ReturnType, typename... Args>
-    struct function<ReturnType(Args...), returns_value<ReturnType>>
-        : _value_function_base<ReturnType, Args...>
+    class function_ref<ReturnType(Args...)>
     {
-        template<class Class>
-        using mem_func_t = ReturnType(Class::*const)(Args...);
+        union _bound_t
+        {
+            void* object;
+            void(*function)();
+        };
 
-        template<class Class>
-        using const_mem_func_t = ReturnType(Class::*const)(Args...) const;
+        using invoker_t = ReturnType(*)( _bound_t, Args&&... );
+
+        template<typename Function>
+        using _callable_enabler = typename std::enable_if<is_different_function<function_ref, Function>() &&
+                                                          std::is_invocable_r<ReturnType, Function&, Args...>::value>::type;
+
+        template<typename Function>
+        static constexpr auto is_function_pointer()
+        {
+            using function_t = typename std::remove_reference<Function>::type;
+            return std::is_function<function_t>::value ||
+                   std::is_function<typename std::remove_pointer<function_t>::type>::value;
+        }
+
+        template<typename Function, typename... CallArgs>
+        static auto invoke( Function&& f, CallArgs&&... args ) -> ReturnType
+        {
+            if constexpr( is_void<ReturnType>::value )
+            {
+                std::invoke( std::forward<Function>(f), std::forward<CallArgs>(args)... );
+            }
+            else
+            {
+                return std::invoke( std::forward<Function>(f), std::forward<CallArgs>(args)... );
+            }
+        }
+
+        _bound_t bound_;
+        invoker_t invoker_;
+
+    public:
+
+        template<typename Function, typename = _callable_enabler<Function>>
+        function_ref( Function&& f ) noexcept
+        {
+            if constexpr( is_function_pointer<Function>() )
+            {
+                using pointer_t = typename std::decay<Function>::type;
+                bound_.function = reinterpret_cast<void(*)()>( static_cast<pointer_t>(f) );
+                invoker_ = []( _bound_t bound, Args&&... args ) -> ReturnType
+                {
+                    return invoke( reinterpret_cast<pointer_t>(bound.function), std::forward<Args>(args)... );
+                };
+            }
+            else
+            {
+                using object_t = typename std::remove_reference<Function>::type;
+                bound_.object = const_cast<void*>( static_cast<const void*>(std::addressof(f)) );
+                invoker_ = []( _bound_t bound, Args&&... args ) -> ReturnType
+                {
+                    return invoke( *static_cast<object_t*>(bound.object), std::forward<Args>(args)... );
+                };
+            }
+        }
+
+        template<auto Method, class Class>
+        function_ref( nontype_t<Method> /*method*/,
+                      Class* const object_ptr ) noexcept
+        {
+            static_assert( std::is_invocable_r<ReturnType, decltype(Method), Class*, Args...>::value, "Function: Member function does not match the reference signature" );
+            bound_.object = const_cast<void*>( static_cast<const void*>(object_ptr) );
+            invoker_ = []( _bound_t bound, Args&&... args ) -> ReturnType
+            {
+                return invoke( Method, static_cast<Class*>(bound.object), std::forward<Args>(args)... );
+            };
+        }
+
+        auto operator()( Args... args ) const -> ReturnType
+        {
+            return invoker_( bound_, std::forward<Args>(args)... );
+        }
+    };
+
+// Compile-time bound function
+
+    // Empty function bound to a free function known at compile time. Has the call and result semantics of
+    // function<ReturnType(*)(Args...)>, but is never empty nor expired and calls compile to a direct call
+    template<auto Function, typename Policy = default_policy, typename = decltype(Function)>
+    struct static_function;
+
+    template<auto Function, typename Policy, typename ReturnType, typename... Args>
+    struct _static_function_base
+    {
+        using return_t = typename std::conditional<is_void<ReturnType>::value, void, function_result_t<ReturnType>>::type;
+
+        // The target is part of the type and cannot be released; kept as a no-op for generic code
+        constexpr void disconnect() const noexcept {}
+
+        constexpr auto empty() const noexcept -> bool { return false; }
+        constexpr auto expired() const noexcept -> bool { return false; }
+        constexpr auto valid() const noexcept -> bool { return true; }
+        constexpr operator bool() const noexcept { return true; }
+
+        template<typename... FunctionArgs>
+        auto operator()( FunctionArgs&&... args ) const noexcept( Policy::is_nothrow ) -> return_t
+        {
+            if constexpr( Policy::is_nothrow )
+            {
+                return call( std::forward<FunctionArgs>(args)... );
+            }
+            else
+            {
+                try
+                {
+                    return call( std::forward<FunctionArgs>(args)... );
+                }
+                catch( const function_exception& e )
+                {
+                    if( e.is_passthrough() )
+                    {
+                        throw;
+                    }
+                }
+
+                if constexpr( !is_void<ReturnType>::value )
+                {
+                    return no_value;
+                }
+            }
+        }
+
+    private:
+
+        template<typename... FunctionArgs>
+        static auto call( FunctionArgs&&... args ) -> return_t
+        {
+            if constexpr( is_void<ReturnType>::value )
+            {
+                Function( std::forward<FunctionArgs>(args)... );
+            }
+            else
+            {
+                return _make_result<ReturnType>( [&]() -> decltype(auto) { return Function( std::forward<FunctionArgs>(args)... ); } );
+            }
+        }
+    };
+
+    template<auto Function, typename Policy, typename ReturnType, typename... Args>
+    struct static_function<Function, Policy, ReturnType(*)(Args...)>
+        : _static_function_base<Function, Policy, ReturnType, Args...>
+    {};
+
+    template<auto Function, typename Policy, typename ReturnType, typename... Args>
+    struct static_function<Function, Policy, ReturnType(*)(Args...) noexcept>
+        : _static_function_base<Function, Policy, ReturnType, Args...>
+    {};
+
+// Overload set handler
+
+    // Candidate of the overload set resolution, restricted to signatures returning the requested type
+    template<std::size_t Index, typename ReturnType, typename Function>
+    struct _overload_candidate
+    {
+        struct _disabled_t {};
+        void operator()( _disabled_t ) const;
+    };
+
+    template<std::size_t Index, typename ReturnType, typename... Args>
+    struct _overload_candidate<Index, ReturnType, ReturnType(Args...)>
+    {
+        auto operator()( Args... ) const -> std::integral_constant<std::size_t, Index>;
+    };
+
+    template<typename ReturnType, typename Indices, typename... Functions>
+    struct _overload_resolver;
+
+    template<typename ReturnType, std::size_t... Is, typename... Functions>
+    struct _overload_resolver<ReturnType, std::index_sequence<Is...>, Functions...>
+        : _overload_candidate<Is, ReturnType, Functions>...
+    {
+        using _overload_candidate<Is, ReturnType, Functions>::operator()...;
+    };
+
+    template<typename Resolver, typename Enabler, typename... Args>
+    struct _overload_index_impl
+    {
+        static constexpr bool found = false;
+        static constexpr std::size_t value = 0;
+    };
+
+    template<typename Resolver, typename... Args>
+    struct _overload_index_impl<Resolver, std::void_t<decltype(std::declval<const Resolver&>()(std::declval<Args>()...))>, Args...>
+    {
+        static constexpr bool found = true;
+        static constexpr std::size_t value = decltype(std::declval<const Resolver&>()(std::declval<Args>()...))::value;
+    };
+
+    // Index of the best viable signature for the argument types, following the normal C++ overload rules
+    template<typename ReturnType, typename Functions, typename... Args>
+    struct _overload_index;
+
+    template<typename ReturnType, typename... Functions, typename... Args>
+    struct _overload_index<ReturnType, std::tuple<Functions...>, Args...>
+        : _overload_index_impl<_overload_resolver<ReturnType, std::index_sequence_for<Functions...>, Functions...>, void, Args...>
+    {
+        static_assert( _overload_index::found, "No unambiguous function signature in the overload set matches the arguments" );
+    };
+
+    // Tuple of one function per signature, sharing a single copy of the connected callable. Copies of the set
+    // share that callable too; use shared_overload_set for one sentinel and a thunk table in a single object
+    template<typename... Functions>
+    class overload_set
+    {
+        using OverloadSet = std::tuple<function<Functions>...>;
+        OverloadSet overload_set_ {};
+
+        template <typename T, typename Tuple>
+        struct has_type;
+
+        template <typename T>
+        struct has_type<T, std::tuple<>> : std::false_type {};
+
+        template <typename T, typename U, typename... Ts>
+        struct has_type<T, std::tuple<U, Ts...>> : has_type<T, std::tuple<Ts...>> {};
+
+        template <typename T, typename... Ts>
+        struct has_type<T, std::tuple<T, Ts...>> : std::true_type {};
+
+        template <typename T>
+        using has_overload = has_type<T, OverloadSet>;
 
-        template<class Class>
-        void connect( const sentinel_opt_t& sentinel,
-                      Class* const object_ptr,
-                      const mem_func_t<Class>& method_ptr )
+        // Forwards every signature to the one shared copy of the callable
+        template<typename Callable>
+        struct _shared_callable
         {
-            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args){ return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
-        }
+            std::shared_ptr<Callable> callable;
 
-        template<class Class>
-        void connect( const sentinel_opt_t& sentinel,
-                      const Class* const object_ptr,
-                      const const_mem_func_t<Class>& method_ptr )
-        {
-            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args){ return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
-        }
+            template<typename... Args>
+            auto operator()( Args&&... args ) const -> decltype(auto)
+            {
+                return std::invoke( *callable, std::forward<Args>(args)... );
+            }
+        };
 
-        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<function, Function, Sentinel>>
-        void connect( const Sentinel& sentinel,
-                      Function&& f )
+        template<typename Sentinel, typename Function>
+        void assign_overload( Sentinel&& sentinel, Function&& func )
         {
-            this->connect_impl( sentinel, std::forward<Function>(f) );
+            using callable_t = typename std::decay<Function>::type;
+            const _shared_callable<callable_t> shared { std::make_shared<callable_t>( std::forward<Function>(func) ) };
+            std::apply( [&]( function<Functions>&... functions )
+            {
+                ( functions.connect(sentinel, shared), ... );
+            }, overload_set_ );
         }
 
-        template<class Class>
-        void connect( Class* const object_ptr,
-                      const mem_func_t<Class>& method_ptr )
-        {
-            connect( no_value, object_ptr, method_ptr );
-        }
+    public:
 
-        template<class Class>
-        void connect( const Class* const object_ptr,
-                      const const_mem_func_t<Class>& method_ptr )
+        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<overload_set, Function, Sentinel>>
+        void connect( const Sentinel& sentinel,
+                      Function&& f )
         {
-            connect( no_value, object_ptr, method_ptr );
+            assign_overload( sentinel, std::forward<Function>(f) );
         }
 
-        template<typename Function, typename = _function_enabler<function, Function>>
+        template<typename Function, typename = _function_enabler<overload_set, Function>>
         void connect( Function&& f )
         {
             connect( no_value, std::forward<Function>(f) );
         }
 
-        template<typename Function, typename = _function_enabler<function, Function>>
-        auto operator=( Function&& f ) -> function&
+        // Calls from threads other than the executor's are posted to it; all signatures must return void
+        template<typename Executor, typename Function, typename = _executor_enabler<Executor>, typename = _function_enabler<overload_set, Function>>
+        void connect( Executor& executor,
+                      const sentinel_opt_t& sentinel,
+                      Function&& f )
         {
-            connect( this->slot_.sentinel, std::forward<Function>(f) );
-            return *this;
+            using callable_t = typename std::decay<Function>::type;
+            auto callable = std::make_shared<callable_t>( std::forward<Function>(f) );
+            std::apply( [&]( function<Functions>&... functions )
+            {
+                ( functions.connect(sentinel, typename _executor_binding<Executor, callable_t, Functions>::type(executor, callable, sentinel)), ... );
+            }, overload_set_ );
         }
 
-        function() = default;
-
-        template<class Class>
-        function( const sentinel_opt_t& sentinel,
-                  Class* const object_ptr,
-                  const mem_func_t<Class>& method_ptr )
+        template<typename Executor, typename Function, typename = _executor_enabler<Executor>, typename = _function_enabler<overload_set, Function>>
+        void connect( Executor& executor,
+                      Function&& f )
         {
-            connect( sentinel, object_ptr, method_ptr );
+            connect( executor, no_value, std::forward<Function>(f) );
         }
 
-        template<class Class>
-        function( const sentinel_opt_t& sentinel,
-                  const Class* const object_ptr,
-                  const const_mem_func_t<Class>& method_ptr )
-        {
-            connect( sentinel, object_ptr, method_ptr );
-        }
+        overload_set() = default;
 
-        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<function, Function, Sentinel>>
-        function( const Sentinel& sentinel,
-                  Function&& f )
+        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<overload_set, Function, Sentinel>>
+        overload_set( const Sentinel& sentinel,
+                      Function&& f )
         {
             connect( sentinel, std::forward<Function>(f) );
         }
 
-        template<class Class>
-        function( Class* const object_ptr,
-                  const mem_func_t<Class>& method_ptr )
+        template<typename Function, typename = _function_enabler<overload_set, Function>>
+        overload_set( Function&& f )
         {
-            connect( no_value, object_ptr, method_ptr );
+            connect( no_value, std::forward<Function>(f) );
         }
 
-        template<class Class>
-        function( const Class* const object_ptr,
-                  const const_mem_func_t<Class>& method_ptr )
+        template<typename Function>
+        auto get() -> function<Function>&
         {
-            connect( no_value, object_ptr, method_ptr );
+            static_assert( has_overload<function<Function>>(), "No such function signature found in the overload set" );
+            return std::get<function<Function>>( overload_set_ );
         }
 
-        template<typename Function, typename = _function_enabler<function, Function>>
-        function( Function&& f )
+        template<typename Function>
+        auto get() const -> const function<Function>&
         {
-            connect( no_value, std::forward<Function>(f) );
+            static_assert( has_overload<function<Function>>(), "No such function signature found in the overload set" );
+            return std::get<function<Function>>( overload_set_ );
         }
-    };
 
-    // Function reference
-    template<typename ReturnType, typename... Args>
-    struct function<ReturnType(*)(Args...), returns_value<ReturnType>>
-        : _value_function_base<ReturnType, Args...>
-    {
-        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<function, Function, Sentinel>>
-        void connect( const Sentinel& sentinel,
-                      Function&& f )
+        template<typename ReturnType = void, typename... Args>
+        auto call( Args&&... args ) -> typename std::enable_if<is_void<ReturnType>::value, void>::type
         {
-            this->connect_impl( sentinel, std::forward<Function>(f) );
+            std::get<_overload_index<ReturnType, std::tuple<Functions...>, Args&&...>::value>( overload_set_ )( std::forward<Args>(args)... );
         }
 
-        template<typename Function, typename = _function_enabler<function, Function>>
-        void connect( Function&& f )
+        template<typename ReturnType, typename... Args>
+        auto call( Args&&... args ) -> typename std::enable_if<!is_void<ReturnType>::value, function_result_t<ReturnType>>::type
         {
-            connect( no_value, std::forward<Function>(f) );
+            return std::get<_overload_index<ReturnType, std::tuple<Functions...>, Args&&...>::value>( overload_set_ )( std::forward<Args>(args)... );
         }
 
-        function() = default;
-
-        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<function, Function, Sentinel>>
-        function( const Sentinel& sentinel,
-                  Function&& f )
+        template<typename ReturnType = void, typename... Args>
+        auto operator()( Args&&... args ) -> typename std::enable_if<is_void<ReturnType>::value, void>::type
         {
-            connect( sentinel, std::forward<Function>(f) );
+            call<ReturnType>( std::forward<Args>(args)... );
         }
 
-        template<typename Function, typename = _function_enabler<function, Function>>
-        function( Function&& f )
+        template<typename ReturnType, typename... Args>
+        auto operator()( Args&&... args ) -> typename std::enable_if<!is_void<ReturnType>::value, function_result_t<ReturnType>>::type
         {
-            connect( no_value, std::forward<Function>(f) );
+            return call<ReturnType>( std::forward<Args>(args)... );
         }
     };
 
-    // Member function reference
-    template<typename ReturnType, typename Class, typename... Args>
-    struct function<ReturnType(Class::*)(Args...), returns_value<ReturnType>>
-        : _value_function_base<ReturnType, Args...>
+    // Overload set keeping a single copy of the callable and one sentinel, dispatched through a
+    // per-callable table of signature thunks. Connecting costs one allocation regardless of the signature count
+    template<typename... Functions>
+    class shared_overload_set
     {
-        using mem_func_t = ReturnType(Class::*)(Args...);
+        template<typename Function>
+        struct _thunk;
 
-        void connect( const sentinel_opt_t& sentinel,
-                      Class* const object_ptr,
-                      const mem_func_t& method_ptr )
+        template<typename ReturnType, typename... Args>
+        struct _thunk<ReturnType(Args...)>
         {
-            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args){ return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
-        }
+            // Parameters are taken as the signature declares them, so arguments convert at the indirect call
+            using type = ReturnType(*)( void*, Args... );
+            using return_t = ReturnType;
 
-        void connect( Class* const object_ptr,
-                      const mem_func_t& method_ptr )
-        {
-            connect( no_value, object_ptr, method_ptr );
-        }
+            template<typename Callable>
+            static auto invoke( void* object, Args... args ) -> ReturnType
+            {
+                if constexpr( is_void<ReturnType>::value )
+                {
+                    std::invoke( *static_cast<Callable*>(object), std::forward<Args>(args)... );
+                }
+                else
+                {
+                    return std::invoke( *static_cast<Callable*>(object), std::forward<Args>(args)... );
+                }
+            }
+        };
 
-        function() = default;
+        template<typename Function>
+        struct _is_invocable;
 
-        function( const sentinel_opt_t& sentinel,
-                  Class* const object_ptr,
-                  const mem_func_t& method_ptr )
+        template<typename ReturnType, typename... Args>
+        struct _is_invocable<ReturnType(Args...)>
         {
-            connect( sentinel, object_ptr, method_ptr );
-        }
+            template<typename Callable>
+            static constexpr bool value = std::is_invocable_r<ReturnType, Callable&, Args...>::value;
+        };
 
-        function( Class* const object_ptr,
-                  const mem_func_t& method_ptr )
-        {
-            connect( no_value, object_ptr, method_ptr );
-        }
-    };
+        template<typename T, typename... Ts>
+        struct _index_of;
 
-    // Member const function reference
-    template<typename ReturnType, typename Class, typename... Args>
-    struct function<ReturnType(Class::*)(Args...) const, returns_value<ReturnType>>
-        : _value_function_base<ReturnType, Args...>
-    {
-        using const_mem_func_t = ReturnType(Class::*const)(Args...) const;
+        template<typename T, typename... Ts>
+        struct _index_of<T, T, Ts...> : std::integral_constant<std::size_t, 0> {};
 
-        void connect( const sentinel_opt_t& sentinel,
-                      const Class* const object_ptr,
-                      const const_mem_func_t& method_ptr )
+        template<typename T, typename U, typename... Ts>
+        struct _index_of<T, U, Ts...> : std::integral_constant<std::size_t, 1 + _index_of<T, Ts...>::value> {};
+
+        template<typename T>
+        using has_overload = std::disjunction<std::is_same<T, Functions>...>;
+
+        template<typename ReturnType, typename... Args>
+        using _overload_t = typename std::tuple_element<_overload_index<ReturnType, std::tuple<Functions...>, Args...>::value, std::tuple<Functions...>>::type;
+
+        struct _vtable
         {
-            this->connect_impl( sentinel, [object_ptr, method_ptr](auto&&... args){ return (object_ptr->*method_ptr)(std::forward<Args>(args)...); } );
-        }
+            void*(*copy)( const void* );
+            void(*destroy)( void* );
+            std::tuple<typename _thunk<Functions>::type...> thunks;
+        };
 
-        void connect( const Class* const object_ptr,
-                      const const_mem_func_t& method_ptr )
+        template<typename Callable>
+        static auto copy_callable( const void* object ) -> void*
         {
-            connect( no_value, object_ptr, method_ptr );
+            return new Callable( *static_cast<const Callable*>(object) );
         }
 
-        function() = default;
-
-        function( const sentinel_opt_t& sentinel,
-                  const Class* const object_ptr,
-                  const const_mem_func_t& method_ptr )
+        template<typename Callable>
+        static void destroy_callable( void* object )
         {
-            connect( sentinel, object_ptr, method_ptr );
+            delete static_cast<Callable*>( object );
         }
 
-        function( const Class* const object_ptr,
-                  const const_mem_func_t& method_ptr )
+        template<typename Callable>
+        static constexpr _vtable vtable_for { &copy_callable<Callable>, &destroy_callable<Callable>, { &_thunk<Functions>::template invoke<Callable>... } };
+
+        void* object_ = nullptr;
+        const _vtable* vtable_ = nullptr;
+        sentinel_opt_t sentinel_ {};
+
+        template<typename Function, typename... Args>
+        auto invoke( Args&&... args ) const
         {
-            connect( no_value, object_ptr, method_ptr );
+            static_assert( has_overload<Function>(), "No such function signature found in the overload set" );
+            using return_t = typename _thunk<Function>::return_t;
+
+            try
+            {
+                const _sentinel_pin pin( sentinel_ );
+                if( valid() )
+                {
+                    if constexpr( is_void<return_t>::value )
+                    {
+                        std::get<_index_of<Function, Functions...>::value>( vtable_->thunks )( object_, std::forward<Args>(args)... );
+                    }
+                    else
+                    {
+                        return function_result_t<return_t>{ std::get<_index_of<Function, Functions...>::value>( vtable_->thunks )( object_, std::forward<Args>(args)... ) };
+                    }
+                }
+            }
+            catch( const function_exception& e )
+            {
+                if( e.is_passthrough() )
+                {
+                    throw;
+                }
+            }
+
+            if constexpr( !is_void<return_t>::value )
+            {
+                return function_result_t<return_t>{ no_value };
+            }
         }
-    };
-    
-// Overload set handler
 
-    template<typename... Functions>
-    class overload_set
-    {
-        using OverloadSet = std::tuple<function<Functions>...>;
-        OverloadSet overload_set_ {};
+    public:
 
-        template <typename T, typename Tuple>
-        struct has_type;
+    // Utilities
 
-        template <typename T>
-        struct has_type<T, std::tuple<>> : std::false_type {};
+        void disconnect()
+        {
+            if( vtable_ != nullptr )
+            {
+                vtable_->destroy( object_ );
+            }
 
-        template <typename T, typename U, typename... Ts>
-        struct has_type<T, std::tuple<U, Ts...>> : has_type<T, std::tuple<Ts...>> {};
+            object_ = nullptr;
+            vtable_ = nullptr;
+            sentinel_ = no_value;
+        }
 
-        template <typename T, typename... Ts>
-        struct has_type<T, std::tuple<T, Ts...>> : std::true_type {};
+        auto empty() const -> bool
+        {
+            return vtable_ == nullptr;
+        }
 
-        template <typename T>
-        using has_overload = has_type<T, OverloadSet>;
+        auto expired() const -> bool
+        {
+            return _sentinel_expired( sentinel_ );
+        }
 
-        template<typename Sentinel, typename Function, std::size_t...Is>
-        void assign_overload( Sentinel&& sentinel, Function&& func, std::index_sequence<Is...> /*seq*/ )
+        auto valid() const -> bool
         {
-            using expander = int[];
-            (void)expander { 0, ((void)std::get<Is>(overload_set_).connect(std::forward<Sentinel>(sentinel), std::forward<Function>(func)), 0)... };
+            return !expired() && !empty();
         }
 
-        template<typename Sentinel, typename Function>
-        void assign_overload( Sentinel&& sentinel, Function&& func )
+        operator bool() const
         {
-            assign_overload( std::forward<Sentinel>(sentinel), std::forward<Function>(func), std::make_index_sequence<sizeof...(Functions)>() );
+            return valid();
         }
 
-    public:
+    // Connection
 
-        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<overload_set, Function, Sentinel>>
+        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<shared_overload_set, Function, Sentinel>>
         void connect( const Sentinel& sentinel,
                       Function&& f )
         {
-            assign_overload( sentinel, std::forward<Function>(f) );
+            using callable_t = typename std::decay<Function>::type;
+            static_assert( std::conjunction<std::bool_constant<_is_invocable<Functions>::template value<callable_t>>...>(), "Function: Callable does not match every signature of the overload set" );
+
+            auto* object = new callable_t( std::forward<Function>(f) );
+            disconnect();
+            object_ = object;
+            vtable_ = &vtable_for<callable_t>;
+            sentinel_ = sentinel;
         }
 
-        template<typename Function, typename = _function_enabler<overload_set, Function>>
+        template<typename Function, typename = _function_enabler<shared_overload_set, Function>>
         void connect( Function&& f )
         {
             connect( no_value, std::forward<Function>(f) );
         }
 
-        overload_set() = default;
+        shared_overload_set() = default;
 
-        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<overload_set, Function, Sentinel>>
-        overload_set( const Sentinel& sentinel,
-                      Function&& f )
+        template<typename Sentinel, typename Function, typename = _sentinel_function_enabler<shared_overload_set, Function, Sentinel>>
+        shared_overload_set( const Sentinel& sentinel,
+                             Function&& f )
         {
             connect( sentinel, std::forward<Function>(f) );
         }
 
-        template<typename Function, typename = _function_enabler<overload_set, Function>>
-        overload_set( Function&& f )
+        template<typename Function, typename = _function_enabler<shared_overload_set, Function>>
+        shared_overload_set( Function&& f )
         {
             connect( no_value, std::forward<Function>(f) );
         }
 
-        template<typename Function>
-        auto get() -> function<Function>&
+        shared_overload_set( const shared_overload_set& other )
+            : object_( other.vtable_ != nullptr ? other.vtable_->copy(other.object_) : nullptr ),
+              vtable_( other.vtable_ ),
+              sentinel_( other.sentinel_ )
+        {}
+
+        shared_overload_set( shared_overload_set&& other ) noexcept
+            : object_( std::exchange(other.object_, nullptr) ),
+              vtable_( std::exchange(other.vtable_, nullptr) ),
+              sentinel_( std::move(other.sentinel_) )
+        {}
+
+        auto operator=( const shared_overload_set& other ) -> shared_overload_set&
         {
-            static_assert( has_overload<function<Function>>(), "No such function signature found in the overload set" );
-            return std::get<function<Function>>( overload_set_ );
+            if( this != &other )
+            {
+                shared_overload_set copy( other );
+                *this = std::move( copy );
+            }
+            return *this;
         }
 
-        template<typename Function>
-        auto get() const -> const function<Function>&
+        auto operator=( shared_overload_set&& other ) noexcept -> shared_overload_set&
         {
-            static_assert( has_overload<function<Function>>(), "No such function signature found in the overload set" );
-            return std::get<function<Function>>( overload_set_ );
+            if( this != &other )
+            {
+                disconnect();
+                object_ = std::exchange( other.object_, nullptr );
+                vtable_ = std::exchange( other.vtable_, nullptr );
+                sentinel_ = std::move( other.sentinel_ );
+            }
+            return *this;
+        }
+
+        ~shared_overload_set()
+        {
+            disconnect();
         }
 
+    // Call
+
         template<typename ReturnType = void, typename... Args>
-        auto call( Args... args ) -> typename std::enable_if<is_void<ReturnType>::value, void>::type
+        auto call( Args&&... args ) const -> typename std::enable_if<is_void<ReturnType>::value, void>::type
         {
-            get<ReturnType(Args...)>()( std::forward<Args>(args)... );
+            invoke<_overload_t<ReturnType, Args&&...>>( std::forward<Args>(args)... );
         }
 
         template<typename ReturnType, typename... Args>
-        auto call( Args... args ) -> typename std::enable_if<!is_void<ReturnType>::value, optional<ReturnType>>::type
+        auto call( Args&&... args ) const -> typename std::enable_if<!is_void<ReturnType>::value, function_result_t<ReturnType>>::type
         {
-            return get<ReturnType(Args...)>()( std::forward<Args>(args)... );
+            return invoke<_overload_t<ReturnType, Args&&...>>( std::forward<Args>(args)... );
         }
 
         template<typename ReturnType = void, typename... Args>
-        auto operator()( Args... args ) -> typename std::enable_if<is_void<ReturnType>::value, void>::type
+        auto operator()( Args&&... args ) const -> typename std::enable_if<is_void<ReturnType>::value, void>::type
         {
-            call( std::forward<Args>(args)... );
+            call<ReturnType>( std::forward<Args>(args)... );
         }
 
         template<typename ReturnType, typename... Args>
-        auto operator()( Args... args ) -> typename std::enable_if<!is_void<ReturnType>::value, optional<ReturnType>>::type
+        auto operator()( Args&&... args ) const -> typename std::enable_if<!is_void<ReturnType>::value, function_result_t<ReturnType>>::type
         {
-            return call( std::forward<Args>(args)... );
+            return call<ReturnType>( std::forward<Args>(args)... );
         }
     };
-    
+
 } // namespace hpp
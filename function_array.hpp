@@ -0,0 +1,281 @@
+#pragma once
+
+#include "function.hpp"
+
+namespace hpp
+{
+// Function array
+
+    template<typename FunctionSignature, std::size_t PayloadSize = 2 * sizeof(void*)>
+    class function_array;
+
+    // Parameter type through which entries receive a dispatch argument. Copyable by-value arguments are shared
+    // by every entry as lvalues, move-only by-value and rvalue reference arguments are passed on as rvalues
+    template<typename Arg>
+    using _array_arg_t = typename std::conditional<std::is_reference<Arg>::value || !std::is_copy_constructible<Arg>::value,
+                                                   Arg&&, Arg&>::type;
+
+    // Structure-of-arrays container for large numbers of void callables, e.g. per-entity update hooks.
+    // Sentinel generation tags, invokers and inline callable payloads live in separate dense arrays. The liveness
+    // check of an entry reads its tag and the pooled counter the tag refers to, never the payload, and dispatch
+    // only touches the payloads of live entries. Sentinels must be generation based (intrusive_lifetime_sentinel,
+    // synchronized_lifetime_sentinel, sentinel_registry, connection_group...). Only entries with a synchronized
+    // sentinel are called inside an epoch critical section, where retiring a synchronized sentinel is rejected
+    template<typename... Args, std::size_t PayloadSize>
+    class function_array<void(Args...), PayloadSize>
+    {
+        using storage_t = inline_storage<PayloadSize>;
+
+        struct _payload_t
+        {
+            alignas(storage_t::alignment) unsigned char bytes[storage_t::size];
+        };
+
+        using invoker_t = void(*)( void*, _array_arg_t<Args>... );
+        using relocator_t = void(*)( void*, void* );
+
+        template<typename Callable>
+        static void invoke( void* payload, _array_arg_t<Args>... args )
+        {
+            std::invoke( *static_cast<Callable*>(payload), static_cast<_array_arg_t<Args>>(args)... );
+        }
+
+        // Moves the callable to the target when given one, destroys the source in either case
+        template<typename Callable>
+        static void relocate( void* target, void* source )
+        {
+            if( target != nullptr )
+            {
+                ::new( target ) Callable( std::move(*static_cast<Callable*>(source)) );
+            }
+
+            static_cast<Callable*>(source)->~Callable();
+        }
+
+        // Counter of entries without a sentinel, never advanced
+        static auto always_live() -> const generation_counter_t&
+        {
+            static const generation_counter_t counter { 0 };
+            return counter;
+        }
+
+        void grow()
+        {
+            const auto capacity = capacity_ == 0 ? 16 : capacity_ * 2;
+            auto payloads = std::make_unique<_payload_t[]>( capacity );
+
+            for( std::size_t i = 0; i < relocators_.size(); ++i )
+            {
+                relocators_[i]( payloads[i].bytes, payloads_[i].bytes );
+            }
+
+            payloads_ = std::move( payloads );
+            capacity_ = capacity;
+        }
+
+        void destroy( std::size_t index )
+        {
+            relocators_[index]( nullptr, payloads_[index].bytes );
+        }
+
+        std::vector<const generation_counter_t*> counters_ {};
+        std::vector<generation_t> generations_ {};
+        std::vector<bool> synchronized_ {};
+        std::vector<invoker_t> invokers_ {};
+        std::vector<relocator_t> relocators_ {};
+        std::unique_ptr<_payload_t[]> payloads_ {};
+        std::size_t capacity_ = 0;
+
+    public:
+
+        function_array() = default;
+        function_array( const function_array& ) = delete;
+        auto operator=( const function_array& ) -> function_array& = delete;
+
+        function_array( function_array&& other ) noexcept
+            : counters_( std::exchange(other.counters_, {}) ),
+              generations_( std::exchange(other.generations_, {}) ),
+              synchronized_( std::exchange(other.synchronized_, {}) ),
+              invokers_( std::exchange(other.invokers_, {}) ),
+              relocators_( std::exchange(other.relocators_, {}) ),
+              payloads_( std::exchange(other.payloads_, {}) ),
+              capacity_( std::exchange(other.capacity_, 0) )
+        {}
+
+        auto operator=( function_array&& other ) noexcept -> function_array&
+        {
+            if( this != &other )
+            {
+                clear();
+                counters_ = std::exchange( other.counters_, {} );
+                generations_ = std::exchange( other.generations_, {} );
+                synchronized_ = std::exchange( other.synchronized_, {} );
+                invokers_ = std::exchange( other.invokers_, {} );
+                relocators_ = std::exchange( other.relocators_, {} );
+                payloads_ = std::exchange( other.payloads_, {} );
+                capacity_ = std::exchange( other.capacity_, 0 );
+            }
+            return *this;
+        }
+
+        ~function_array()
+        {
+            clear();
+        }
+
+    // Insertion
+
+        template<typename Function>
+        void push_back( const sentinel_opt_t& sentinel,
+                        Function&& f )
+        {
+            using callable_t = typename std::decay<Function>::type;
+            static_assert( fits_inline_storage<callable_t, storage_t>(), "Function: Callable does not fit in the function array payload (too large, over-aligned or throwing move)" );
+
+            const generation_counter_t* counter = &always_live();
+            generation_t generation = 0;
+            bool synchronized = false;
+
+            if( sentinel != no_value )
+            {
+                if( sentinel->generation_counter() == nullptr )
+                {
+                    throw std::invalid_argument( "Function: Function array sentinels must be generation based" );
+                }
+
+                counter = sentinel->generation_counter();
+                generation = sentinel->generation();
+                synchronized = sentinel->is_synchronized();
+            }
+
+            if( relocators_.size() == capacity_ )
+            {
+                grow();
+            }
+
+            counters_.reserve( capacity_ );
+            generations_.reserve( capacity_ );
+            synchronized_.reserve( capacity_ );
+            invokers_.reserve( capacity_ );
+            relocators_.reserve( capacity_ );
+
+            ::new( static_cast<void*>(payloads_[relocators_.size()].bytes) ) callable_t( std::forward<Function>(f) );
+            counters_.push_back( counter );
+            generations_.push_back( generation );
+            synchronized_.push_back( synchronized );
+            invokers_.push_back( &invoke<callable_t> );
+            relocators_.push_back( &relocate<callable_t> );
+        }
+
+        template<typename Function, typename = _function_enabler<function_array, Function>>
+        void push_back( Function&& f )
+        {
+            push_back( no_value, std::forward<Function>(f) );
+        }
+
+        template<auto Method, class Class>
+        void push_back( const sentinel_opt_t& sentinel,
+                        Class* const object_ptr )
+        {
+            push_back( sentinel, [object_ptr](auto&&... args){ return (object_ptr->*Method)(std::forward<Args>(args)...); } );
+        }
+
+    // Utilities
+
+        auto size() const -> std::size_t
+        {
+            return relocators_.size();
+        }
+
+        auto empty() const -> bool
+        {
+            return relocators_.empty();
+        }
+
+        void clear()
+        {
+            for( std::size_t i = 0; i < relocators_.size(); ++i )
+            {
+                destroy( i );
+            }
+
+            counters_.clear();
+            generations_.clear();
+            synchronized_.clear();
+            invokers_.clear();
+            relocators_.clear();
+        }
+
+        // Removes expired entries, keeping the order of the remaining ones, and returns how many were removed
+        auto erase_expired() -> std::size_t
+        {
+            std::size_t write = 0;
+
+            for( std::size_t read = 0; read < relocators_.size(); ++read )
+            {
+                if( counters_[read]->load(std::memory_order_acquire) != generations_[read] )
+                {
+                    destroy( read );
+                    continue;
+                }
+
+                if( write != read )
+                {
+                    relocators_[read]( payloads_[write].bytes, payloads_[read].bytes );
+                    counters_[write] = counters_[read];
+                    generations_[write] = generations_[read];
+                    synchronized_[write] = synchronized_[read];
+                    invokers_[write] = invokers_[read];
+                    relocators_[write] = relocators_[read];
+                }
+
+                ++write;
+            }
+
+            const auto removed = relocators_.size() - write;
+            counters_.resize( write );
+            generations_.resize( write );
+            synchronized_.resize( write );
+            invokers_.resize( write );
+            relocators_.resize( write );
+            return removed;
+        }
+
+    // Dispatch
+
+        // Calls every live entry in insertion order. Liveness is checked right before each call, so entries
+        // expired by an earlier callback of the same dispatch are skipped. Entries must not be added or removed
+        // while dispatching. Arguments are taken once and passed to the entries as _array_arg_t describes
+        void dispatch( Args... args ) const
+        {
+            const auto count = counters_.size();
+
+            for( std::size_t index = 0; index < count; ++index )
+            {
+                const _sentinel_pin pin { static_cast<bool>(synchronized_[index]) };
+                if( counters_[index]->load(std::memory_order_acquire) != generations_[index] )
+                {
+                    continue;
+                }
+
+                try
+                {
+                    invokers_[index]( payloads_[index].bytes, static_cast<_array_arg_t<Args>>(args)... );
+                }
+                catch( const function_exception& e )
+                {
+                    if( e.is_passthrough() )
+                    {
+                        throw;
+                    }
+                }
+            }
+        }
+
+        void operator()( Args... args ) const
+        {
+            dispatch( std::forward<Args>(args)... );
+        }
+    };
+
+} // namespace hpp
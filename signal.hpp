@@ -0,0 +1,936 @@
+#pragma once
+
+#include "function.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+
+namespace hpp
+{
+// Connection handle
+
+    // Lightweight handle to a signal slot; safe to use after the signal has been destroyed
+    class connection
+    {
+    public:
+
+        struct _signal_ops
+        {
+            void(*disconnect)( void*, std::uint64_t );
+            bool(*connected)( const void*, std::uint64_t );
+        };
+
+        connection() = default;
+
+        connection( void* signal,
+                    const _signal_ops& ops,
+                    const sentinel_t& signal_sentinel,
+                    std::uint64_t id )
+            : signal_( signal ),
+              ops_( &ops ),
+              signal_sentinel_( signal_sentinel ),
+              id_( id )
+        {}
+
+        void disconnect()
+        {
+            if( connected() )
+            {
+                ops_->disconnect( signal_, id_ );
+            }
+
+            signal_ = nullptr;
+        }
+
+        auto connected() const -> bool
+        {
+            return signal_ != nullptr &&
+                   !signal_sentinel_.expired() &&
+                   ops_->connected( signal_, id_ );
+        }
+
+    private:
+
+        void* signal_ = nullptr;
+        const _signal_ops* ops_ = nullptr;
+        sentinel_t signal_sentinel_ {};
+        std::uint64_t id_ = 0;
+    };
+
+// Result combiners
+
+    // Combiners reduce the results of value returning slots. They provide result_type, operator()( const optional<T>& )
+    // returning false once no further results are needed, merge( Combiner&& ) folding in the partial result of the
+    // slots that follow, and result() &&. Parallel emissions start every chunk but the first from a default constructed combiner
+    struct discard_results
+    {
+        using result_type = void;
+
+        template<typename Result>
+        auto operator()( Result&& ) -> bool
+        {
+            return true;
+        }
+
+        void merge( discard_results&& ) {}
+        void result() && {}
+    };
+
+    // Result of the first slot that returned a value
+    template<typename T>
+    struct first_valid
+    {
+        using result_type = optional<T>;
+
+        auto operator()( const optional<T>& value ) -> bool
+        {
+            if( value != no_value )
+            {
+                result_ = value;
+                return false;
+            }
+            return true;
+        }
+
+        void merge( first_valid&& other )
+        {
+            if( result_ == no_value )
+            {
+                result_ = std::move( other.result_ );
+            }
+        }
+
+        auto result() && -> result_type
+        {
+            return std::move( result_ );
+        }
+
+    private:
+
+        optional<T> result_ {};
+    };
+
+    // Sum of every returned value, starting from the given initial value
+    template<typename T>
+    struct sum
+    {
+        using result_type = T;
+
+        sum( T initial = T{} )
+            : total_( std::move(initial) )
+        {}
+
+        auto operator()( const optional<T>& value ) -> bool
+        {
+            if( value != no_value )
+            {
+                total_ += *value;
+            }
+            return true;
+        }
+
+        void merge( sum&& other )
+        {
+            total_ += std::move( other.total_ );
+        }
+
+        auto result() && -> result_type
+        {
+            return std::move( total_ );
+        }
+
+    private:
+
+        T total_;
+    };
+
+    // Every returned value in slot order
+    template<typename T>
+    struct collect
+    {
+        using result_type = std::vector<T>;
+
+        auto operator()( const optional<T>& value ) -> bool
+        {
+            if( value != no_value )
+            {
+                values_.push_back( *value );
+            }
+            return true;
+        }
+
+        void merge( collect&& other )
+        {
+            values_.insert( values_.end(), std::make_move_iterator(other.values_.begin()), std::make_move_iterator(other.values_.end()) );
+        }
+
+        auto result() && -> result_type
+        {
+            return std::move( values_ );
+        }
+
+    private:
+
+        std::vector<T> values_ {};
+    };
+
+    // Smallest returned value, the earliest one on ties
+    template<typename T>
+    struct minimum
+    {
+        using result_type = optional<T>;
+
+        auto operator()( const optional<T>& value ) -> bool
+        {
+            if( value != no_value && (result_ == no_value || *value < *result_) )
+            {
+                result_ = value;
+            }
+            return true;
+        }
+
+        void merge( minimum&& other )
+        {
+            operator()( other.result_ );
+        }
+
+        auto result() && -> result_type
+        {
+            return std::move( result_ );
+        }
+
+    private:
+
+        optional<T> result_ {};
+    };
+
+    // Shared state of a parallel emission. Chunks are claimed through an atomic counter by the posted tasks and by the
+    // emitting thread itself, so the emission completes even when no executor thread picks a task up
+    template<typename Combiner, typename Runner>
+    struct _parallel_emission
+    {
+        _parallel_emission( std::size_t chunk_count,
+                            Runner runner )
+            : partials( chunk_count ),
+              remaining( chunk_count ),
+              run( std::move(runner) )
+        {}
+
+        void work()
+        {
+            for( auto chunk = next.fetch_add(1); chunk < partials.size(); chunk = next.fetch_add(1) )
+            {
+                try
+                {
+                    run( chunk, partials[chunk] );
+                }
+                catch( ... )
+                {
+                    std::lock_guard<std::mutex> lock( mutex );
+                    if( error == nullptr )
+                    {
+                        error = std::current_exception();
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock( mutex );
+                if( --remaining == 0 )
+                {
+                    finished.notify_all();
+                }
+            }
+        }
+
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            finished.wait( lock, [this]{ return remaining == 0; } );
+        }
+
+        std::vector<optional<Combiner>> partials;
+        std::atomic<std::size_t> next { 0 };
+        std::size_t remaining;
+        std::mutex mutex {};
+        std::condition_variable finished {};
+        std::exception_ptr error {};
+        Runner run;
+    };
+
+    // Span around an emission, recorded when the policy defines emission_probe_t
+    template<typename Policy, typename = void>
+    struct _emission_span
+    {
+        explicit _emission_span( const void* ) noexcept {}
+    };
+
+    template<typename Policy>
+    struct _emission_span<Policy, std::void_t<typename Policy::emission_probe_t>>
+    {
+        typename Policy::emission_probe_t probe;
+        int exceptions = std::uncaught_exceptions();
+
+        explicit _emission_span( const void* signal ) noexcept
+            : probe( signal )
+        {
+        }
+
+        ~_emission_span()
+        {
+            probe.finish( std::uncaught_exceptions() > exceptions ? call_outcome::passthrough : call_outcome::value );
+        }
+    };
+
+// Signal definition
+
+    // Multicast function. Slots are stored in a contiguous array and emitted in connection order; slots whose
+    // sentinel expired or that were disconnected are compacted away during the next outermost emission.
+    // Slots may connect and disconnect from within an emission, newly connected slots run from the next one.
+    // Results of value returning slots are reduced by the combiner, which discards them by default
+    template<typename FunctionSignature, typename Storage = default_storage, typename Policy = default_policy, typename Combiner = discard_results>
+    class signal
+    {
+    public:
+
+        using function_t = function<FunctionSignature, Storage, Policy>;
+        using result_type = typename Combiner::result_type;
+
+    private:
+
+        struct _slot_t
+        {
+            function_t func;
+            std::uint32_t handle;
+            bool connected;
+        };
+
+        // Locates a slot in slots_ or pending_. Connection ids hold the handle index in their low half and its
+        // generation in their high half, the generation changes whenever the handle is released
+        struct _handle_t
+        {
+            std::size_t position;
+            std::uint32_t generation;
+            bool pending;
+        };
+
+        static constexpr bool uses_memory_resource = _uses_memory_resource<Storage>::value;
+        static constexpr std::uint32_t no_handle = ~std::uint32_t( 0 );
+
+        template<typename T>
+        using _vector_t = typename std::conditional<uses_memory_resource, std::pmr::vector<T>, std::vector<T>>::type;
+
+        using _slots_t = _vector_t<_slot_t>;
+
+        // Finishes an emission, also when a passthrough exception leaves a slot
+        struct _emission_guard
+        {
+            const signal& owner;
+            bool compacting;
+            std::size_t read = 0;
+            std::size_t write = 0;
+
+            ~_emission_guard()
+            {
+                if( compacting )
+                {
+                    auto& slots = owner.slots_;
+                    if( write != read )
+                    {
+                        slots.erase( slots.begin() + static_cast<std::ptrdiff_t>(write),
+                                     slots.begin() + static_cast<std::ptrdiff_t>(read) );
+
+                        // Slots the emission did not reach moved down
+                        for( auto i = write; i < slots.size(); ++i )
+                        {
+                            owner.handles_[slots[i].handle].position = i;
+                        }
+                    }
+
+                    owner.merge_pending();
+                }
+
+                --owner.emitting_;
+            }
+        };
+
+        static void disconnect_slot( void* self, std::uint64_t id )
+        {
+            static_cast<signal*>( self )->disconnect( id );
+        }
+
+        static auto is_slot_connected( const void* self, std::uint64_t id ) -> bool
+        {
+            return static_cast<const signal*>( self )->connected( id );
+        }
+
+        static constexpr connection::_signal_ops ops_ { &disconnect_slot, &is_slot_connected };
+
+        static auto is_live( const _slot_t& slot ) -> bool
+        {
+            return slot.connected && slot.func.valid();
+        }
+
+        auto acquire_handle() -> std::uint32_t
+        {
+            if( free_handle_ != no_handle )
+            {
+                return std::exchange( free_handle_, static_cast<std::uint32_t>(handles_[free_handle_].position) );
+            }
+
+            if( handles_.size() == no_handle )
+            {
+                throw std::length_error( "Function: Too many signal slots" );
+            }
+
+            handles_.push_back( _handle_t{ 0, 1, false } );
+            return static_cast<std::uint32_t>( handles_.size() - 1 );
+        }
+
+        // Invalidates the ids of the handle and links it into the free list through its position
+        void release_handle( std::uint32_t index ) const
+        {
+            auto& handle = handles_[index];
+            ++handle.generation;
+            handle.position = std::exchange( free_handle_, index );
+        }
+
+        auto add( function_t&& func ) -> connection
+        {
+            const auto index = acquire_handle();
+            auto& slots = emitting_ == 0 ? slots_ : pending_;
+
+            try
+            {
+                slots.push_back( _slot_t{ std::move(func), index, true } );
+            }
+            catch( ... )
+            {
+                release_handle( index );
+                throw;
+            }
+
+            auto& handle = handles_[index];
+            handle.position = slots.size() - 1;
+            handle.pending = emitting_ != 0;
+
+            const auto id = static_cast<std::uint64_t>( handle.generation ) << 32 | index;
+            return { this, ops_, lifetime_.get_sentinel(), id };
+        }
+
+        void merge_pending() const
+        {
+            if( !pending_.empty() )
+            {
+                for( auto& slot : pending_ )
+                {
+                    auto& handle = handles_[slot.handle];
+                    handle.position += slots_.size();
+                    handle.pending = false;
+                }
+
+                slots_.insert( slots_.end(), std::make_move_iterator(pending_.begin()), std::make_move_iterator(pending_.end()) );
+                pending_.clear();
+            }
+        }
+
+        auto find( std::uint64_t id ) const -> _slot_t*
+        {
+            const auto index = static_cast<std::size_t>( id & no_handle );
+            if( index >= handles_.size() || handles_[index].generation != id >> 32 )
+            {
+                return nullptr;
+            }
+
+            const auto& handle = handles_[index];
+            return &( handle.pending ? pending_ : slots_ )[handle.position];
+        }
+
+        // Calls a slot and feeds its result to the combiner, returns whether the combiner wants more results
+        template<typename SlotCombiner, typename... EmitArgs>
+        static auto call_slot( const function_t& func,
+                               SlotCombiner& combiner,
+                               EmitArgs&... args ) -> bool
+        {
+            if constexpr( std::is_void<decltype(func(args...))>::value )
+            {
+                func( args... );
+                return true;
+            }
+            else
+            {
+                return combiner( func(args...) );
+            }
+        }
+
+        // Slots are built empty and then connected, so that their callables are allocated from the signal's resource
+        template<typename... ConnectArgs>
+        auto make_slot_function( ConnectArgs&&... args ) -> function_t
+        {
+            if constexpr( uses_memory_resource )
+            {
+                function_t func;
+                func.set_memory_resource( slots_.get_allocator().resource() );
+                if constexpr( sizeof...(ConnectArgs) > 0 )
+                {
+                    func.connect( std::forward<ConnectArgs>(args)... );
+                }
+                return func;
+            }
+            else
+            {
+                return function_t( std::forward<ConnectArgs>(args)... );
+            }
+        }
+
+        mutable _slots_t slots_ {};
+        mutable _slots_t pending_ {};
+        mutable _vector_t<_handle_t> handles_ {};
+        mutable std::uint32_t free_handle_ = no_handle;
+        mutable std::size_t emitting_ = 0;
+        intrusive_lifetime_sentinel lifetime_ {};
+
+    public:
+
+        signal() = default;
+        signal( const signal& ) = delete;
+        auto operator=( const signal& ) -> signal& = delete;
+
+        // Allocates the slot array and large slot captures from the given resource, which must outlive the signal
+        explicit signal( std::pmr::memory_resource* resource )
+            : slots_( resource ),
+              pending_( resource ),
+              handles_( resource )
+        {
+            static_assert( uses_memory_resource, "Function: Signal storage does not use a memory resource" );
+        }
+
+    // Connection
+
+        // Accepts every argument combination accepted by the function connect methods and, without a memory
+        // resource, by the function constructors
+        template<typename... ConnectArgs>
+        auto connect( ConnectArgs&&... args ) -> connection
+        {
+            return add( make_slot_function(std::forward<ConnectArgs>(args)...) );
+        }
+
+        template<auto Method, class Class>
+        auto connect( const sentinel_opt_t& sentinel,
+                      Class* const object_ptr ) -> connection
+        {
+            auto func = make_slot_function();
+            func.template connect<Method>( sentinel, object_ptr );
+            return add( std::move(func) );
+        }
+
+        template<auto Method, class Class>
+        auto connect( Class* const object_ptr ) -> connection
+        {
+            auto func = make_slot_function();
+            func.template connect<Method>( object_ptr );
+            return add( std::move(func) );
+        }
+
+        void disconnect( std::uint64_t id )
+        {
+            if( auto* slot = find(id) )
+            {
+                // The slot may be running, so it is only released once the emission is over
+                slot->connected = false;
+            }
+        }
+
+        void disconnect_all()
+        {
+            for( auto* slots : { &slots_, &pending_ } )
+            {
+                for( auto& slot : *slots )
+                {
+                    slot.connected = false;
+                }
+            }
+
+            if( emitting_ == 0 )
+            {
+                for( auto* slots : { &slots_, &pending_ } )
+                {
+                    for( const auto& slot : *slots )
+                    {
+                        release_handle( slot.handle );
+                    }
+
+                    slots->clear();
+                }
+            }
+        }
+
+        auto connected( std::uint64_t id ) const -> bool
+        {
+            const auto* slot = find( id );
+            return slot != nullptr && is_live( *slot );
+        }
+
+    // Utilities
+
+        // Number of live slots
+        auto size() const -> std::size_t
+        {
+            std::size_t count = 0;
+            for( const auto* slots : { &slots_, &pending_ } )
+            {
+                for( const auto& slot : *slots )
+                {
+                    count += is_live( slot ) ? 1 : 0;
+                }
+            }
+
+            return count;
+        }
+
+        auto empty() const -> bool
+        {
+            return size() == 0;
+        }
+
+    // Emission
+
+        template<typename... EmitArgs>
+        auto emit( EmitArgs&&... args ) const -> result_type
+        {
+            return combine( Combiner{}, std::forward<EmitArgs>(args)... );
+        }
+
+        template<typename... EmitArgs>
+        auto operator()( EmitArgs&&... args ) const -> result_type
+        {
+            return emit( std::forward<EmitArgs>(args)... );
+        }
+
+        // Emits with the given combiner instead of the signal's one
+        template<typename SlotCombiner, typename... EmitArgs>
+        auto combine( SlotCombiner combiner,
+                      EmitArgs&&... args ) const -> typename SlotCombiner::result_type
+        {
+            [[maybe_unused]] const _emission_span<Policy> span { this };
+            const auto count = slots_.size();
+            _emission_guard guard { *this, emitting_++ == 0 };
+            bool combining = true;
+
+            for( ; guard.read < count; ++guard.read )
+            {
+                auto& slot = slots_[guard.read];
+
+                if( combining && is_live(slot) )
+                {
+                    combining = call_slot( slot.func, combiner, args... );
+                }
+                else if( !combining && !guard.compacting )
+                {
+                    break;
+                }
+
+                if( guard.compacting && is_live(slots_[guard.read]) )
+                {
+                    if( guard.write != guard.read )
+                    {
+                        slots_[guard.write] = std::move( slots_[guard.read] );
+                        handles_[slots_[guard.write].handle].position = guard.write;
+                    }
+
+                    ++guard.write;
+                }
+                else if( guard.compacting )
+                {
+                    release_handle( slots_[guard.read].handle );
+                }
+            }
+
+            return std::move( combiner ).result();
+        }
+
+        // Splits the slots into chunks of the given size that run on the executor and on the calling thread, then
+        // merges the partial results in slot order. Slots must tolerate concurrent calls and must not connect or
+        // disconnect slots of this signal while the emission runs. Runs serially when already on the executor
+        template<typename Executor, typename... EmitArgs>
+        auto emit_parallel( Executor& executor,
+                            std::size_t chunk_size,
+                            EmitArgs&&... args ) const -> result_type
+        {
+            return combine_parallel( executor, chunk_size, Combiner{}, std::forward<EmitArgs>(args)... );
+        }
+
+        template<typename Executor, typename SlotCombiner, typename... EmitArgs>
+        auto combine_parallel( Executor& executor,
+                               std::size_t chunk_size,
+                               SlotCombiner combiner,
+                               EmitArgs&&... args ) const -> typename SlotCombiner::result_type
+        {
+            static_assert( is_executor<Executor>::value, "Function: Parallel emission requires an executor" );
+
+            const auto count = slots_.size();
+            chunk_size = std::max<std::size_t>( chunk_size, 1 );
+            const auto chunk_count = ( count + chunk_size - 1 ) / chunk_size;
+
+            if( chunk_count <= 1 || executor.running_in_this_thread() )
+            {
+                return combine( std::move(combiner), std::forward<EmitArgs>(args)... );
+            }
+
+            [[maybe_unused]] const _emission_span<Policy> span { this };
+            ++emitting_;
+            _emission_guard guard { *this, false };
+
+            auto runner = [this, count, chunk_size, &args...]( std::size_t chunk, optional<SlotCombiner>& partial )
+            {
+                if( partial == no_value )
+                {
+                    partial.emplace();
+                }
+
+                const auto last = std::min( count, (chunk + 1) * chunk_size );
+
+                for( auto i = chunk * chunk_size; i < last; ++i )
+                {
+                    const auto& slot = slots_[i];
+                    if( is_live(slot) && !call_slot(slot.func, *partial, args...) )
+                    {
+                        break;
+                    }
+                }
+            };
+
+            auto emission = std::make_shared<_parallel_emission<SlotCombiner, decltype(runner)>>( chunk_count, std::move(runner) );
+            emission->partials[0].emplace( std::move(combiner) );
+
+            for( std::size_t i = 1; i < chunk_count; ++i )
+            {
+                executor.post( [emission]{ emission->work(); } );
+            }
+
+            emission->work();
+            emission->wait();
+
+            if( emission->error != nullptr )
+            {
+                std::rethrow_exception( emission->error );
+            }
+
+            auto& result = *emission->partials[0];
+            for( std::size_t i = 1; i < chunk_count; ++i )
+            {
+                result.merge( std::move(*emission->partials[i]) );
+            }
+
+            return std::move( result ).result();
+        }
+    };
+
+// Concurrent signal
+
+    // Signal that can be emitted from any number of threads while others connect and disconnect.
+    // Emitters read an immutable slot array published through an atomic pointer inside an epoch
+    // critical section and take no locks; writers serialize among themselves, publish a modified copy
+    // and reclaim old arrays once no emitter can observe them. Expired slots are skipped during emission
+    // and pruned by the next writer
+    template<typename FunctionSignature, typename Storage = default_storage, typename Policy = default_policy>
+    class concurrent_signal
+    {
+    public:
+
+        using function_t = function<FunctionSignature, Storage, Policy>;
+
+    private:
+
+        struct _slot_t
+        {
+            function_t func;
+            std::uint64_t id;
+        };
+
+        using _snapshot_t = std::vector<_slot_t>;
+
+        struct _retired_t
+        {
+            const _snapshot_t* snapshot;
+            std::uint64_t epoch;
+        };
+
+        static void disconnect_slot( void* self, std::uint64_t id )
+        {
+            static_cast<concurrent_signal*>( self )->disconnect( id );
+        }
+
+        static auto is_slot_connected( const void* self, std::uint64_t id ) -> bool
+        {
+            return static_cast<const concurrent_signal*>( self )->connected( id );
+        }
+
+        static constexpr connection::_signal_ops ops_ { &disconnect_slot, &is_slot_connected };
+
+        // Slots stay in connection order, so their ids are sorted
+        template<typename Slots>
+        static auto find( Slots& slots, std::uint64_t id ) -> decltype(slots.begin())
+        {
+            const auto slot = std::lower_bound( slots.begin(), slots.end(), id, []( const _slot_t& lhs, std::uint64_t rhs )
+            {
+                return lhs.id < rhs;
+            } );
+
+            return slot != slots.end() && slot->id == id ? slot : slots.end();
+        }
+
+        // Publishes a copy of the current slots without expired ones, modified by the given function. Requires the write lock
+        template<typename Modifier>
+        void update( Modifier&& modify )
+        {
+            const auto* current = snapshot_.load( std::memory_order_relaxed );
+            auto next = std::make_unique<_snapshot_t>();
+            next->reserve( current->size() + 1 );
+
+            for( const auto& slot : *current )
+            {
+                if( slot.func.valid() )
+                {
+                    next->push_back( slot );
+                }
+            }
+
+            modify( *next );
+            snapshot_.store( next.release(), std::memory_order_seq_cst );
+            retired_.push_back( { current, _epoch_domain::instance().advance() } );
+            reclaim();
+        }
+
+        // Frees retired slot arrays that no emitter can observe anymore. Requires the write lock
+        void reclaim()
+        {
+            auto& domain = _epoch_domain::instance();
+            auto last = std::remove_if( retired_.begin(), retired_.end(), [&domain]( const _retired_t& retired )
+            {
+                if( domain.is_safe(retired.epoch) )
+                {
+                    delete retired.snapshot;
+                    return true;
+                }
+                return false;
+            } );
+            retired_.erase( last, retired_.end() );
+        }
+
+        auto add( function_t&& func ) -> connection
+        {
+            std::lock_guard<std::mutex> lock( write_mutex_ );
+            const auto id = ++last_id_;
+            update( [&]( _snapshot_t& slots ){ slots.push_back( _slot_t{ std::move(func), id } ); } );
+            return { this, ops_, lifetime_.get_sentinel(), id };
+        }
+
+        std::atomic<const _snapshot_t*> snapshot_ { new _snapshot_t() };
+        std::mutex write_mutex_;
+        std::vector<_retired_t> retired_ {};
+        std::uint64_t last_id_ = 0;
+        intrusive_lifetime_sentinel lifetime_ {};
+
+    public:
+
+        concurrent_signal() = default;
+        concurrent_signal( const concurrent_signal& ) = delete;
+        auto operator=( const concurrent_signal& ) -> concurrent_signal& = delete;
+
+        // No emission may be in progress when the signal is destroyed
+        ~concurrent_signal()
+        {
+            for( const auto& retired : retired_ )
+            {
+                delete retired.snapshot;
+            }
+
+            delete snapshot_.load( std::memory_order_relaxed );
+        }
+
+    // Connection
+
+        // Accepts every argument combination accepted by the function constructors
+        template<typename... ConnectArgs>
+        auto connect( ConnectArgs&&... args ) -> connection
+        {
+            return add( function_t(std::forward<ConnectArgs>(args)...) );
+        }
+
+        template<auto Method, class Class>
+        auto connect( const sentinel_opt_t& sentinel,
+                      Class* const object_ptr ) -> connection
+        {
+            return add( function_t(sentinel, nontype<Method>, object_ptr) );
+        }
+
+        template<auto Method, class Class>
+        auto connect( Class* const object_ptr ) -> connection
+        {
+            return add( function_t(nontype<Method>, object_ptr) );
+        }
+
+        void disconnect( std::uint64_t id )
+        {
+            std::lock_guard<std::mutex> lock( write_mutex_ );
+            update( [id]( _snapshot_t& slots )
+            {
+                const auto slot = find( slots, id );
+                if( slot != slots.end() )
+                {
+                    slots.erase( slot );
+                }
+            } );
+        }
+
+        void disconnect_all()
+        {
+            std::lock_guard<std::mutex> lock( write_mutex_ );
+            update( []( _snapshot_t& slots ){ slots.clear(); } );
+        }
+
+        auto connected( std::uint64_t id ) const -> bool
+        {
+            epoch_guard guard;
+            const auto& slots = *snapshot_.load( std::memory_order_acquire );
+            const auto slot = find( slots, id );
+            return slot != slots.end() && slot->func.valid();
+        }
+
+    // Utilities
+
+        // Number of live slots in the current version
+        auto size() const -> std::size_t
+        {
+            epoch_guard guard;
+            const auto& slots = *snapshot_.load( std::memory_order_acquire );
+            return static_cast<std::size_t>( std::count_if(slots.begin(), slots.end(), []( const _slot_t& slot ){ return slot.func.valid(); }) );
+        }
+
+        auto empty() const -> bool
+        {
+            return size() == 0;
+        }
+
+    // Emission
+
+        // Lock-free; slots connected or disconnected concurrently take effect from the next emission
+        template<typename... EmitArgs>
+        void emit( EmitArgs&&... args ) const
+        {
+            [[maybe_unused]] const _emission_span<Policy> span { this };
+            epoch_guard guard;
+            for( const auto& slot : *snapshot_.load(std::memory_order_acquire) )
+            {
+                slot.func( args... );
+            }
+        }
+
+        template<typename... EmitArgs>
+        void operator()( EmitArgs&&... args ) const
+        {
+            emit( std::forward<EmitArgs>(args)... );
+        }
+    };
+
+} // namespace hpp
@@ -0,0 +1,144 @@
+// Checks of async_function, run by ctest
+
+#include "async_function.hpp"
+
+#include <cassert>
+#include <coroutine>
+
+namespace
+{
+    // Resumed by hand, like an I/O completion owned by the sentinel owner
+    struct manual_event
+    {
+        struct awaiter
+        {
+            manual_event* event;
+
+            auto await_ready() const noexcept -> bool
+            {
+                return false;
+            }
+
+            void await_suspend( std::coroutine_handle<> handle ) noexcept
+            {
+                event->waiter = handle;
+            }
+
+            void await_resume() const noexcept
+            {}
+        };
+
+        std::coroutine_handle<> waiter {};
+
+        auto wait() -> awaiter
+        {
+            return { this };
+        }
+
+        void fire()
+        {
+            std::exchange( waiter, nullptr ).resume();
+        }
+    };
+
+    // A call waiting on a callee that never completes is resumed without a value by cancel()
+    void cancel_resumes_waiting_call()
+    {
+        manual_event event;
+        hpp::async_function<int(int)> f( [&event]( int value ) -> hpp::task<int>
+        {
+            co_await event.wait();
+            co_return value * 2;
+        } );
+
+        auto call = f( 21 );
+        call.start();
+        assert( !call.done() && event.waiter );
+
+        assert( f.cancel() == 1 );
+        assert( call.done() && call.get() == hpp::no_value );
+
+        // The callee completing afterwards frees itself
+        event.fire();
+        assert( f.cancel() == 0 );
+    }
+
+    void completed_call_is_not_cancelled()
+    {
+        manual_event event;
+        hpp::async_function<void()> f( [&event]() -> hpp::task<void>
+        {
+            co_await event.wait();
+        } );
+
+        auto call = f();
+        call.start();
+        event.fire();
+        assert( call.done() && call.get() );
+        assert( f.cancel() == 0 );
+    }
+
+    void destruction_cancels_waiting_calls()
+    {
+        manual_event event;
+        auto f = std::make_unique<hpp::async_function<int()>>( [&event]() -> hpp::task<int>
+        {
+            co_await event.wait();
+            co_return 1;
+        } );
+
+        auto call = ( *f )();
+        call.start();
+        f.reset();
+        assert( call.done() && call.get() == hpp::no_value );
+        event.fire();
+    }
+
+    // Destroying the awaiting task unregisters its wait, the callee can still complete
+    void destroyed_call_is_unregistered()
+    {
+        manual_event event;
+        hpp::async_function<int()> f( [&event]() -> hpp::task<int>
+        {
+            co_await event.wait();
+            co_return 1;
+        } );
+
+        {
+            auto call = f();
+            call.start();
+        }
+
+        assert( f.cancel() == 0 );
+        event.fire();
+    }
+
+    // Synchronous callees report a translated function_exception as a failed call, like value returning ones
+    void translated_sync_exception_fails_the_call()
+    {
+        bool ran = false;
+        hpp::async_function<void()> f( [&ran]{ ran = true; throw hpp::function_exception(); } );
+        auto call = f();
+        call.start();
+        assert( ran && call.done() && !call.get() );
+
+        hpp::async_function<void()> g( []{} );
+        auto succeeded = g();
+        succeeded.start();
+        assert( succeeded.done() && succeeded.get() );
+
+        hpp::async_function<int()> h( []() -> int { throw hpp::function_exception(); } );
+        auto missing = h();
+        missing.start();
+        assert( missing.done() && missing.get() == hpp::no_value );
+    }
+}
+
+int main()
+{
+    cancel_resumes_waiting_call();
+    completed_call_is_not_cancelled();
+    destruction_cancels_waiting_calls();
+    destroyed_call_is_unregistered();
+    translated_sync_exception_fails_the_call();
+}
@@ -0,0 +1,83 @@
+// Checks of compact_function, run by ctest
+
+#include "function.hpp"
+
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+    struct receiver : hpp::intrusive_lifetime_sentinel
+    {
+        int calls = 0;
+
+        void method()
+        {
+            ++calls;
+        }
+    };
+
+    struct weak_receiver : hpp::lifetime_sentinel
+    {
+        int calls = 0;
+
+        void method()
+        {
+            ++calls;
+        }
+    };
+
+    // A sentinel the compact handle cannot hold leaves the callable and the sentinel of the function unchanged
+    void rejected_connect_keeps_function()
+    {
+        auto owner = std::make_unique<receiver>();
+        hpp::compact_function<void()> f;
+        f.connect( owner->get_sentinel(), owner.get(), &receiver::method );
+
+        auto other = std::make_unique<weak_receiver>();
+        bool threw = false;
+        try
+        {
+            f.connect( other->get_sentinel(), other.get(), &weak_receiver::method );
+        }
+        catch( const std::invalid_argument& )
+        {
+            threw = true;
+        }
+
+        assert( threw );
+        other.reset();
+
+        f();
+        assert( owner->calls == 1 );
+
+        owner.reset();
+        assert( !f.valid() );
+        f();
+    }
+
+    void rejected_connect_keeps_empty_function()
+    {
+        auto other = std::make_unique<weak_receiver>();
+        hpp::compact_function<void()> f;
+
+        try
+        {
+            f.connect( other->get_sentinel(), other.get(), &weak_receiver::method );
+        }
+        catch( const std::invalid_argument& )
+        {
+        }
+
+        assert( f.empty() && !f.valid() );
+        other.reset();
+        f();
+    }
+}
+
+int main()
+{
+    rejected_connect_keeps_function();
+    rejected_connect_keeps_empty_function();
+}
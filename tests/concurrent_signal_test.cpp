@@ -0,0 +1,114 @@
+// Checks of concurrent_signal, run by ctest
+
+#include "signal.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct receiver : hpp::intrusive_lifetime_sentinel
+    {
+        int calls = 0;
+    };
+
+    void connections_and_expiry()
+    {
+        hpp::concurrent_signal<void(int)> signal;
+        int sum = 0;
+
+        auto first = signal.connect( [&sum]( int value ){ sum += value; } );
+        auto second = signal.connect( [&sum]( int value ){ sum += value * 10; } );
+        signal( 1 );
+        assert( sum == 11 && signal.size() == 2 );
+
+        first.disconnect();
+        assert( !first.connected() && second.connected() );
+        signal( 1 );
+        assert( sum == 21 );
+
+        // Expired slots are skipped and no longer counted
+        auto object = std::make_unique<receiver>();
+        auto* raw = object.get();
+        signal.connect( object->get_sentinel(), [raw]( int ){ ++raw->calls; } );
+        signal( 0 );
+        assert( object->calls == 1 && signal.size() == 2 );
+
+        object.reset();
+        signal( 0 );
+        assert( signal.size() == 1 );
+
+        signal.disconnect_all();
+        signal( 1 );
+        assert( sum == 21 && signal.empty() );
+    }
+
+    // Emitting threads never miss the slot that stays connected while the main thread connects and disconnects
+    // other slots, and a disconnected slot's captures stay alive until no emission can still call it
+    void emission_while_connecting_and_disconnecting()
+    {
+        hpp::concurrent_signal<void()> signal;
+        std::atomic<std::size_t> permanent_calls { 0 };
+        std::atomic<std::size_t> transient_calls { 0 };
+        std::atomic<bool> done { false };
+
+        signal.connect( [&permanent_calls]{ permanent_calls.fetch_add( 1, std::memory_order_relaxed ); } );
+
+        std::vector<std::thread> emitters;
+        std::vector<std::size_t> emissions( 4, 0 );
+        for( std::size_t i = 0; i < emissions.size(); ++i )
+        {
+            emitters.emplace_back( [&, i]
+            {
+                while( !done.load(std::memory_order_relaxed) )
+                {
+                    signal();
+                    ++emissions[i];
+                }
+            } );
+        }
+
+        for( int i = 0; i < 2000; ++i )
+        {
+            auto state = std::make_shared<int>( i );
+            auto connection = signal.connect( [state, &transient_calls]
+            {
+                assert( *state >= 0 );
+                transient_calls.fetch_add( 1, std::memory_order_relaxed );
+            } );
+
+            if( i % 2 == 0 )
+            {
+                connection.disconnect();
+            }
+        }
+
+        done.store( true, std::memory_order_relaxed );
+        for( auto& emitter : emitters )
+        {
+            emitter.join();
+        }
+
+        std::size_t total = 0;
+        for( const auto count : emissions )
+        {
+            total += count;
+        }
+
+        assert( permanent_calls.load() == total );
+        assert( signal.size() == 1 + 1000 );
+
+        const auto before = transient_calls.load();
+        signal();
+        assert( transient_calls.load() == before + 1000 );
+    }
+}
+
+int main()
+{
+    connections_and_expiry();
+    emission_while_connecting_and_disconnecting();
+}
@@ -0,0 +1,57 @@
+// Checks of connection_group, run by ctest
+
+#include "function.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void disconnect_all_expires_connected_functions()
+    {
+        hpp::connection_group group;
+        hpp::function<void()> before( group.get_sentinel(), []{} );
+        group.disconnect_all();
+        hpp::function<void()> after( group.get_sentinel(), []{} );
+
+        assert( before.expired() && after.valid() );
+    }
+
+    // Sentinels may be taken while another thread disconnects the group
+    void disconnect_all_races_get_sentinel()
+    {
+        hpp::connection_group group;
+        std::atomic<bool> done { false };
+        std::vector<hpp::function<void()>> functions;
+
+        std::thread disconnector( [&]
+        {
+            while( !done.load(std::memory_order_relaxed) )
+            {
+                group.disconnect_all();
+            }
+        } );
+
+        for( int i = 0; i < 10000; ++i )
+        {
+            functions.emplace_back( group.get_sentinel(), []{} );
+        }
+
+        done.store( true, std::memory_order_relaxed );
+        disconnector.join();
+        group.disconnect_all();
+
+        for( const auto& f : functions )
+        {
+            assert( f.expired() );
+        }
+    }
+}
+
+int main()
+{
+    disconnect_all_expires_connected_functions();
+    disconnect_all_races_get_sentinel();
+}
@@ -0,0 +1,144 @@
+// Checks of event_queue, run by ctest
+
+#include "event_queue.hpp"
+#include "signal.hpp"
+
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct payload
+    {
+        int value = 0;
+        bool fail = false;
+
+        payload( int v, bool f ) : value( v ), fail( f ) {}
+
+        payload( const payload& other )
+            : value( other.value ),
+              fail( other.fail )
+        {
+            if( fail )
+            {
+                throw std::runtime_error( "copy failed" );
+            }
+        }
+    };
+
+    // A post whose argument copy throws must not stall the events posted after it
+    void throwing_post_is_skipped()
+    {
+        hpp::event_queue<void(payload), 8> queue;
+        const payload good_first { 1, false };
+        const payload bad { 2, true };
+        const payload good_last { 3, false };
+
+        assert( queue.post(good_first) );
+
+        bool threw = false;
+        try
+        {
+            queue.post( bad );
+        }
+        catch( const std::runtime_error& )
+        {
+            threw = true;
+        }
+        assert( threw );
+
+        assert( queue.post(good_last) );
+
+        int sum = 0;
+        const auto count = queue.dispatch( [&]( const payload& p ){ sum += p.value; } );
+        assert( count == 2 && sum == 4 && queue.empty() );
+
+        // Every cell is still usable after wrapping around
+        for( int round = 0; round < 3; ++round )
+        {
+            for( int i = 0; i < 8; ++i )
+            {
+                assert( queue.post(good_first) );
+            }
+            assert( !queue.post(good_first) );
+            assert( queue.dispatch([]( const payload& ){}) == 8 );
+        }
+    }
+
+    struct receiver : hpp::intrusive_lifetime_sentinel {};
+
+    // Expiry is checked per item, so a call releasing the receiver stops the rest of the batch
+    void expiry_is_checked_per_item()
+    {
+        auto object = std::make_unique<receiver>();
+        std::vector<int> calls;
+        hpp::function<void(int)> f( object->get_sentinel(), [&]( int value )
+        {
+            calls.push_back( value );
+            if( value == 2 )
+            {
+                object.reset();
+            }
+        } );
+
+        hpp::event_queue<void(int), 8> queue;
+        for( int i = 1; i <= 4; ++i )
+        {
+            queue.post( i );
+        }
+
+        assert( queue.dispatch(f) == 4 && queue.empty() );
+        assert( ( calls == std::vector<int>{ 1, 2 } ) );
+    }
+
+    void queued_targets_run_on_dispatch()
+    {
+        int sum = 0;
+        hpp::queued<void(int), 64> f( [&sum]( int value ){ sum += value; } );
+
+        std::vector<std::thread> producers;
+        for( int t = 0; t < 4; ++t )
+        {
+            producers.emplace_back( [&f]
+            {
+                for( int i = 1; i <= 10; ++i )
+                {
+                    while( !f.post(i) )
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            } );
+        }
+
+        for( auto& producer : producers )
+        {
+            producer.join();
+        }
+
+        assert( sum == 0 );
+        assert( f.dispatch(16) == 16 && f.dispatch() == 24 && sum == 4 * 55 );
+
+        // Signals fan each posted call out to every slot
+        hpp::queued<void(int), 8, hpp::signal<void(int)>> signal;
+        signal.target().connect( [&sum]( int value ){ sum += value; } );
+        signal.target().connect( [&sum]( int value ){ sum += value * 10; } );
+        sum = 0;
+        signal.post( 1 );
+        signal.post( 2 );
+        assert( sum == 0 && signal.dispatch() == 2 && sum == 33 && signal.empty() );
+
+        signal( 1 );
+        assert( sum == 44 );
+    }
+}
+
+int main()
+{
+    throwing_post_is_skipped();
+    expiry_is_checked_per_item();
+    queued_targets_run_on_dispatch();
+}
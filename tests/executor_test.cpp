@@ -0,0 +1,91 @@
+// Checks of executor bound functions, run by ctest
+
+#include "function.hpp"
+
+#include <cassert>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    // Event loop owned by the thread that created it, storing its tasks in std::function
+    struct event_loop
+    {
+        std::thread::id owner = std::this_thread::get_id();
+        std::deque<std::function<void()>> tasks;
+
+        auto running_in_this_thread() const -> bool
+        {
+            return std::this_thread::get_id() == owner;
+        }
+
+        template<typename Task>
+        void post( Task&& task )
+        {
+            tasks.emplace_back( std::forward<Task>(task) );
+        }
+
+        void run()
+        {
+            for( ; !tasks.empty(); tasks.pop_front() )
+            {
+                tasks.front()();
+            }
+        }
+    };
+
+    // Posted calls move their arguments, so move-only parameters are accepted
+    void posted_calls_move_arguments()
+    {
+        event_loop loop;
+        int received = 0;
+        hpp::function<void(std::unique_ptr<int>)> f;
+        f.connect( loop, [&]( std::unique_ptr<int> value ){ received = *value; } );
+
+        std::thread( [&]{ f( std::make_unique<int>(7) ); } ).join();
+        assert( received == 0 && loop.tasks.size() == 1 );
+
+        loop.run();
+        assert( received == 7 );
+    }
+
+    // Posted calls pin a synchronized sentinel while they run, so the owner cannot retire it meanwhile
+    void posted_calls_pin_synchronized_sentinels()
+    {
+        event_loop loop;
+        hpp::synchronized_lifetime_sentinel sentinel;
+        bool pinned = false;
+        hpp::function<void()> f;
+
+        f.connect( loop, sentinel.get_sentinel(), [&]
+        {
+            try
+            {
+                sentinel.retire();
+            }
+            catch( const std::logic_error& )
+            {
+                pinned = true;
+            }
+        } );
+
+        std::thread( [&]{ f(); } ).join();
+        loop.run();
+        assert( pinned );
+
+        std::thread( [&]{ f(); } ).join();
+        sentinel.retire();
+        pinned = false;
+        loop.run();
+        assert( !pinned );
+    }
+}
+
+int main()
+{
+    posted_calls_move_arguments();
+    posted_calls_pin_synchronized_sentinels();
+}
@@ -0,0 +1,152 @@
+// Checks of function_array, run by ctest
+
+#include "function_array.hpp"
+
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace
+{
+    struct entity : hpp::intrusive_lifetime_sentinel
+    {
+        int updates = 0;
+    };
+
+    // A callback destroying a later entity prevents that entity's callback from running
+    void expiry_during_dispatch()
+    {
+        auto first = std::make_unique<entity>();
+        auto second = std::make_unique<entity>();
+        hpp::function_array<void()> array;
+
+        array.push_back( first->get_sentinel(), [&]{ ++first->updates; second.reset(); } );
+        array.push_back( second->get_sentinel(), [victim = second.get()]{ ++victim->updates; } );
+
+        array();
+        assert( first->updates == 1 && second == nullptr );
+    }
+
+    void moved_from_array_is_reusable()
+    {
+        hpp::function_array<void(int&)> array;
+        array.push_back( []( int& calls ){ ++calls; } );
+
+        auto moved = std::move( array );
+        assert( array.empty() && moved.size() == 1 );
+
+        array.push_back( []( int& calls ){ calls += 10; } );
+        int calls = 0;
+        array( calls );
+        moved( calls );
+        assert( calls == 11 );
+    }
+
+    // Dispatch from inside a callback of the same array
+    void reentrant_dispatch()
+    {
+        hpp::function_array<void(int)> array;
+        int calls = 0;
+
+        array.push_back( [&]( int depth )
+        {
+            ++calls;
+            if( depth > 0 )
+            {
+                array( depth - 1 );
+            }
+        } );
+        array.push_back( [&]( int ){ ++calls; } );
+
+        array( 1 );
+        assert( calls == 4 );
+    }
+
+    struct synchronized_entity : hpp::synchronized_lifetime_sentinel
+    {
+        ~synchronized_entity()
+        {
+            retire();
+        }
+    };
+
+    // Entries without a synchronized sentinel run outside an epoch critical section, so a callback may destroy
+    // an object retiring its synchronized sentinel
+    void callbacks_may_retire_synchronized_sentinels()
+    {
+        auto owned = std::make_unique<synchronized_entity>();
+        hpp::function_array<void()> array;
+        array.push_back( [&]{ owned.reset(); } );
+
+        array();
+        assert( owned == nullptr );
+    }
+
+    // Entries with a synchronized sentinel are pinned while they run, so their sentinel cannot be retired meanwhile
+    void synchronized_entries_are_pinned()
+    {
+        hpp::synchronized_lifetime_sentinel sentinel;
+        hpp::function_array<void()> array;
+        bool pinned = false;
+
+        array.push_back( sentinel.get_sentinel(), [&]
+        {
+            try
+            {
+                sentinel.retire();
+            }
+            catch( const std::logic_error& )
+            {
+                pinned = true;
+            }
+        } );
+
+        array();
+        assert( pinned );
+
+        sentinel.retire();
+        pinned = false;
+        array();
+        assert( !pinned );
+    }
+
+    void rvalue_and_move_only_arguments_are_forwarded()
+    {
+        int received = 0;
+
+        hpp::function_array<void(std::unique_ptr<int>)> by_value;
+        by_value.push_back( [&]( std::unique_ptr<int> value ){ received += *value; } );
+        by_value( std::make_unique<int>(1) );
+
+        hpp::function_array<void(std::unique_ptr<int>&&)> by_rvalue;
+        by_rvalue.push_back( [&]( std::unique_ptr<int>&& value ){ auto taken = std::move( value ); received += *taken * 10; } );
+        by_rvalue.dispatch( std::make_unique<int>(2) );
+
+        assert( received == 21 );
+    }
+
+    // Copyable by-value arguments are shared by the entries, so no entry sees a moved-from value
+    void copyable_arguments_reach_every_entry()
+    {
+        hpp::function_array<void(std::string)> array;
+        std::string received;
+        array.push_back( [&]( std::string value ){ received += std::move( value ); } );
+        array.push_back( [&]( std::string value ){ received += std::move( value ); } );
+
+        array( std::string("ab") );
+        assert( received == "abab" );
+    }
+}
+
+int main()
+{
+    expiry_during_dispatch();
+    moved_from_array_is_reusable();
+    reentrant_dispatch();
+    callbacks_may_retire_synchronized_sentinels();
+    synchronized_entries_are_pinned();
+    rvalue_and_move_only_arguments_are_forwarded();
+    copyable_arguments_reach_every_entry();
+}
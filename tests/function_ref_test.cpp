@@ -0,0 +1,108 @@
+// Checks of function_ref and nontype member binding, run by ctest
+
+#include "function.hpp"
+
+#include <cassert>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+    static_assert( std::is_trivially_copyable<hpp::function_ref<int(int)>>::value, "function_ref must be trivially copyable" );
+    static_assert( sizeof(hpp::function_ref<int(int)>) == 2 * sizeof(void*), "function_ref must be two pointers" );
+
+    struct receiver : hpp::intrusive_lifetime_sentinel
+    {
+        int total = 0;
+
+        auto add( int value ) -> int { return total += value; }
+        auto get() const -> int { return total; }
+    };
+
+    auto twice( int value ) -> int
+    {
+        return value * 2;
+    }
+
+    // A view refers to the callable, so state changes are visible through it and through copies
+    void views_do_not_copy_the_callable()
+    {
+        int calls = 0;
+        auto counter = [&calls]( int value ) mutable { ++calls; return value; };
+        const hpp::function_ref<int(int)> view( counter );
+        const auto copy = view;
+
+        assert( view(1) == 1 && copy(2) == 2 && calls == 2 );
+
+        struct stateful
+        {
+            int value = 0;
+            auto operator()() -> int { return ++value; }
+        } object;
+
+        const hpp::function_ref<int()> ref( object );
+        ref();
+        ref();
+        assert( object.value == 2 );
+    }
+
+    void function_pointers_are_stored_directly()
+    {
+        const hpp::function_ref<int(int)> from_function( twice );
+        const hpp::function_ref<int(int)> from_pointer( &twice );
+        assert( from_function(3) == 6 && from_pointer(4) == 8 );
+
+        // Return types convert to the signature
+        const hpp::function_ref<long(int)> widened( twice );
+        const hpp::function_ref<void(int)> discarded( twice );
+        discarded( 1 );
+        assert( widened(5) == 10L );
+    }
+
+    void nontype_binds_member_functions()
+    {
+        receiver object;
+        const hpp::function_ref<int(int)> add( hpp::nontype<&receiver::add>, &object );
+        const hpp::function_ref<int()> get( hpp::nontype<&receiver::get>, &object );
+
+        add( 2 );
+        add( 3 );
+        assert( get() == 5 && object.total == 5 );
+    }
+
+    // Reference and move-only arguments are forwarded, not copied
+    void arguments_are_forwarded()
+    {
+        const auto append = []( std::string& target, std::string&& source ){ target += source; };
+        const hpp::function_ref<void(std::string&, std::string&&)> ref( append );
+        std::string text = "a";
+        ref( text, std::string("b") );
+        assert( text == "ab" );
+
+        const auto take = []( std::unique_ptr<int> value ){ return *value; };
+        const hpp::function_ref<int(std::unique_ptr<int>)> owner( take );
+        assert( owner(std::make_unique<int>(7)) == 7 );
+    }
+
+    // hpp::function binds nontype members with a sentinel and stops calling them once it expires
+    void functions_bind_nontype_members()
+    {
+        auto object = std::make_unique<receiver>();
+        hpp::function<int(int)> add( object->get_sentinel(), hpp::nontype<&receiver::add>, object.get() );
+
+        assert( *add(4) == 4 && *add(1) == 5 );
+        object.reset();
+        assert( add(1) == hpp::no_value && add.expired() );
+    }
+}
+
+int main()
+{
+    views_do_not_copy_the_callable();
+    function_pointers_are_stored_directly();
+    nontype_binds_member_functions();
+    arguments_are_forwarded();
+    functions_bind_nontype_members();
+}
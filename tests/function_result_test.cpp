@@ -0,0 +1,121 @@
+// Checks of reference returns and in-place results, run by ctest
+
+#include "function.hpp"
+
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace
+{
+    static_assert( std::is_same<hpp::function_result_t<int&>, hpp::optional<std::reference_wrapper<int>>>::value, "Reference returns must be wrapped" );
+    static_assert( std::is_same<hpp::function_result_t<int>, hpp::optional<int>>::value, "Value returns must be optional" );
+
+    struct receiver : hpp::intrusive_lifetime_sentinel
+    {
+        std::string name = "receiver";
+
+        auto get_name() -> std::string& { return name; }
+    };
+
+    // Counts copies and moves of the returned value
+    struct tracked
+    {
+        static inline int copies = 0;
+        static inline int moves = 0;
+
+        int value = 0;
+
+        explicit tracked( int v ) : value( v ) {}
+        tracked( const tracked& other ) : value( other.value ) { ++copies; }
+        tracked( tracked&& other ) noexcept : value( other.value ) { ++moves; }
+    };
+
+    // Neither copyable nor movable, so it can only be constructed in place
+    struct pinned
+    {
+        int value;
+
+        explicit pinned( int v ) : value( v ) {}
+        pinned( const pinned& ) = delete;
+        pinned( pinned&& ) = delete;
+    };
+
+    void references_are_returned()
+    {
+        int counter = 1;
+        hpp::function<int&()> f( [&counter]() -> int& { return counter; } );
+
+        auto result = f();
+        assert( result.has_value() && &result->get() == &counter );
+        result->get() = 2;
+        assert( counter == 2 );
+
+        receiver object;
+        hpp::function<std::string&()> name( hpp::nontype<&receiver::get_name>, &object );
+        name()->get() += "!";
+        assert( object.name == "receiver!" );
+    }
+
+    void expired_reference_functions_return_no_value()
+    {
+        auto object = std::make_unique<receiver>();
+        hpp::function<std::string&()> name( object->get_sentinel(), hpp::nontype<&receiver::get_name>, object.get() );
+        assert( name()->get() == "receiver" );
+
+        object.reset();
+        assert( name() == hpp::no_value );
+    }
+
+    // Prvalue results are constructed straight inside the returned optional
+    void results_are_constructed_in_place()
+    {
+        hpp::function<tracked(int)> f( []( int value ){ return tracked( value ); } );
+
+        tracked::copies = 0;
+        tracked::moves = 0;
+        const auto result = f( 4 );
+        assert( result->value == 4 && tracked::copies == 0 && tracked::moves == 0 );
+
+        hpp::function<pinned()> make( []{ return pinned( 5 ); } );
+        assert( make()->value == 5 );
+    }
+
+    void invoke_into_reuses_the_result()
+    {
+        bool fail = false;
+        hpp::function<tracked(int)> f( [&fail]( int value ) -> tracked
+        {
+            if( fail )
+            {
+                throw hpp::function_exception();
+            }
+            return tracked( value );
+        } );
+
+        hpp::optional<tracked> result;
+        tracked::copies = 0;
+        tracked::moves = 0;
+        assert( f.invoke_into(result, 1) && result->value == 1 );
+        assert( f.invoke_into(result, 2) && result->value == 2 );
+        assert( tracked::copies == 0 && tracked::moves == 0 );
+
+        // A call without a value leaves the result empty
+        fail = true;
+        assert( !f.invoke_into(result, 3) && result == hpp::no_value );
+
+        hpp::function<tracked(int)> empty;
+        result.emplace( 7 );
+        assert( !empty.invoke_into(result, 1) && result == hpp::no_value );
+    }
+}
+
+int main()
+{
+    references_are_returned();
+    expired_reference_functions_return_no_value();
+    results_are_constructed_in_place();
+    invoke_into_reuses_the_result();
+}
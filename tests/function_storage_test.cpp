@@ -0,0 +1,172 @@
+// Checks of the type-erased callable storage: copies, moves and destruction, run by ctest
+
+#include "function.hpp"
+
+#include <array>
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    // Counts live instances, copies and moves; copies throw while fail is set
+    template<std::size_t PayloadSize>
+    struct counted
+    {
+        static inline int live = 0;
+        static inline int copies = 0;
+        static inline int moves = 0;
+        static inline bool fail = false;
+
+        std::array<char, PayloadSize> payload {};
+        int value;
+
+        explicit counted( int v ) : value( v ) { ++live; }
+
+        counted( const counted& other )
+            : payload( other.payload ),
+              value( other.value )
+        {
+            if( fail )
+            {
+                throw std::runtime_error( "copy failed" );
+            }
+            ++live;
+            ++copies;
+        }
+
+        counted( counted&& other ) noexcept
+            : payload( other.payload ),
+              value( other.value )
+        {
+            ++live;
+            ++moves;
+        }
+
+        ~counted() { --live; }
+
+        auto operator()() const -> int { return value; }
+
+        static void reset_counts()
+        {
+            copies = 0;
+            moves = 0;
+            fail = false;
+        }
+    };
+
+    using small_callable = counted<1>;
+    using large_callable = counted<64>;
+
+    template<typename Callable>
+    void copies_are_independent()
+    {
+        Callable::reset_counts();
+        {
+            const hpp::function<int()> f( Callable(1) );
+            hpp::function<int()> copy( f );
+            assert( Callable::live == 2 && Callable::copies == 1 && *f() == 1 && *copy() == 1 );
+
+            // Assigning over a connected function destroys its callable
+            hpp::function<int()> other( Callable(2) );
+            other = f;
+            assert( Callable::live == 3 && *other() == 1 );
+
+            // Self assignment neither copies nor destroys
+            Callable::copies = 0;
+            auto& self = other;
+            other = self;
+            assert( Callable::live == 3 && Callable::copies == 0 && *other() == 1 );
+        }
+        assert( Callable::live == 0 );
+    }
+
+    // Inline callables are moved once per function move, heap callables are taken over by pointer
+    template<typename Callable>
+    void moves_transfer_the_callable( int moves_per_function_move )
+    {
+        Callable::reset_counts();
+        {
+            hpp::function<int()> f( Callable(3) );
+            Callable::moves = 0;
+
+            hpp::function<int()> moved( std::move(f) );
+            assert( Callable::live == 1 && Callable::moves == moves_per_function_move && Callable::copies == 0 );
+            assert( f.empty() && *moved() == 3 );
+
+            hpp::function<int()> assigned( Callable(4) );
+            assigned = std::move( moved );
+            assert( Callable::live == 1 && *assigned() == 3 && moved.empty() );
+
+            auto& self = assigned;
+            assigned = std::move( self );
+            assert( Callable::live == 1 && *assigned() == 3 );
+        }
+        assert( Callable::live == 0 );
+    }
+
+    template<typename Function>
+    auto throws( Function&& f ) -> bool
+    {
+        try
+        {
+            f();
+        }
+        catch( const std::runtime_error& )
+        {
+            return true;
+        }
+        return false;
+    }
+
+    // A throwing copy leaves both functions as they were and leaks nothing
+    template<typename Callable>
+    void throwing_copies_keep_the_state()
+    {
+        Callable::reset_counts();
+        {
+            const hpp::function<int()> source( Callable(5) );
+            hpp::function<int()> target( Callable(6) );
+            assert( Callable::live == 2 );
+
+            Callable::fail = true;
+            assert( throws([&]{ hpp::function<int()> copy( source ); }) );
+            assert( throws([&]{ target = source; }) );
+            assert( Callable::live == 2 && *source() == 5 && *target() == 6 );
+
+            // Connecting a callable whose copy throws keeps the previous connection
+            const Callable callable( 7 );
+            assert( throws([&]{ target.connect( callable ); }) );
+            assert( Callable::live == 3 && *target() == 6 );
+
+            Callable::fail = false;
+            target.connect( callable );
+            assert( Callable::live == 3 && *target() == 7 );
+        }
+        assert( Callable::live == 0 );
+    }
+
+    void disconnect_destroys_the_callable()
+    {
+        small_callable::reset_counts();
+        large_callable::reset_counts();
+
+        hpp::function<int()> small( small_callable(8) );
+        hpp::function<int()> large( large_callable(9) );
+        small.disconnect();
+        large = nullptr;
+        assert( small_callable::live == 0 && large_callable::live == 0 && small.empty() && large.empty() );
+        assert( small() == hpp::no_value && large() == hpp::no_value );
+    }
+}
+
+int main()
+{
+    copies_are_independent<small_callable>();
+    copies_are_independent<large_callable>();
+    moves_transfer_the_callable<small_callable>( 1 );
+    moves_transfer_the_callable<large_callable>( 0 );
+    throwing_copies_keep_the_state<small_callable>();
+    throwing_copies_keep_the_state<large_callable>();
+    disconnect_destroys_the_callable();
+}
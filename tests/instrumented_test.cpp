@@ -0,0 +1,54 @@
+// Checks of the instrumented call policy, run by ctest
+
+#include "function.hpp"
+
+#include <cassert>
+
+namespace
+{
+    struct tag
+    {
+        static constexpr const char* name = "instrumented_test";
+    };
+
+    using policy = hpp::instrumented<tag>;
+
+    struct counted
+    {
+        static inline int moves = 0;
+        int value;
+
+        explicit counted( int v ) : value( v ) {}
+        counted( counted&& other ) noexcept : value( other.value ) { ++moves; }
+        counted( const counted& ) = delete;
+    };
+
+    void outcomes_are_counted()
+    {
+        hpp::function<int(int), hpp::default_storage, policy> f;
+        assert( !f(1) );
+
+        f.connect( []( int value ){ return value * 2; } );
+        assert( *f(2) == 4 );
+
+        f.connect( []( int ) -> int { throw hpp::function_exception(); } );
+        assert( !f(3) );
+
+        const auto statistics = policy::statistics();
+        assert( statistics.calls == 3 && statistics.no_values == 2 && statistics.passthrough_throws == 0 );
+    }
+
+    // Probing does not add moves to the in-place construction of results
+    void results_are_not_moved()
+    {
+        hpp::function<counted(int), hpp::default_storage, policy> f( []( int value ){ return counted( value ); } );
+        const auto result = f( 5 );
+        assert( result->value == 5 && counted::moves == 0 );
+    }
+}
+
+int main()
+{
+    outcomes_are_counted();
+    results_are_not_moved();
+}
@@ -0,0 +1,93 @@
+// Checks of invoke_batch, run by ctest
+
+#include "function.hpp"
+
+#include <cassert>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    struct receiver : hpp::intrusive_lifetime_sentinel {};
+
+    void void_batches_call_every_input()
+    {
+        int sum = 0;
+        hpp::function<void(int)> f( [&sum]( int value ){ sum += value; } );
+        const std::vector<int> inputs { 1, 2, 3 };
+        f.invoke_batch( inputs );
+        assert( sum == 6 );
+
+        std::vector<std::tuple<int, int>> pairs { { 1, 2 }, { 3, 4 } };
+        hpp::function<void(int, int)> g( [&sum]( int lhs, int rhs ){ sum += lhs * rhs; } );
+        g.invoke_batch( pairs );
+        assert( sum == 6 + 2 + 12 );
+    }
+
+    // Translated exceptions only clear the output of the element that threw
+    void value_batches_translate_per_element()
+    {
+        hpp::function<int(int)> f( []( int value ) -> int
+        {
+            if( value < 0 )
+            {
+                throw hpp::function_exception();
+            }
+            return value * 2;
+        } );
+
+        const std::vector<int> inputs { 1, -1, 3, 4 };
+        std::vector<hpp::optional<int>> outputs( 3 );
+        f.invoke_batch( inputs, outputs );
+
+        assert( *outputs[0] == 2 && outputs[1] == hpp::no_value && *outputs[2] == 6 );
+    }
+
+    void expired_functions_skip_the_batch()
+    {
+        auto object = std::make_unique<receiver>();
+        int calls = 0;
+        hpp::function<int(int)> f( object->get_sentinel(), [&calls]( int value ){ ++calls; return value; } );
+        object.reset();
+
+        const std::vector<int> inputs { 1, 2 };
+        std::vector<hpp::optional<int>> outputs { 7, 7 };
+        f.invoke_batch( inputs, outputs );
+        assert( calls == 0 && outputs[0] == hpp::no_value && outputs[1] == hpp::no_value );
+    }
+
+    // Callables providing invoke_batch receive the whole range in one call
+    struct batching
+    {
+        int* batches;
+        int* calls;
+
+        void operator()( int ) const { ++*calls; }
+
+        void invoke_batch( hpp::span<const int> inputs ) const
+        {
+            ++*batches;
+            *calls += static_cast<int>( inputs.size() );
+        }
+    };
+
+    void batching_callables_receive_the_range()
+    {
+        int batches = 0;
+        int calls = 0;
+        hpp::function<void(int)> f( batching{ &batches, &calls } );
+
+        const std::vector<int> inputs { 1, 2, 3, 4 };
+        f.invoke_batch( inputs );
+        assert( batches == 1 && calls == 4 );
+    }
+}
+
+int main()
+{
+    void_batches_call_every_input();
+    value_batches_translate_per_element();
+    expired_functions_skip_the_batch();
+    batching_callables_receive_the_range();
+}
@@ -0,0 +1,144 @@
+// Checks of memoized and concurrent_memoized, run by ctest
+
+#include "adaptors.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <list>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct receiver : hpp::intrusive_lifetime_sentinel {};
+
+    void results_are_cached()
+    {
+        int calls = 0;
+        hpp::memoized<int(int, int)> add( [&calls]( int lhs, int rhs ){ ++calls; return lhs + rhs; } );
+
+        assert( *add(1, 2) == 3 && *add(1, 2) == 3 && calls == 1 );
+        assert( *add(2, 1) == 3 && calls == 2 && add.size() == 2 );
+
+        // Calls without a value are not cached
+        hpp::memoized<int(int)> failing( [&calls]( int ) -> int { ++calls; throw hpp::function_exception(); } );
+        assert( failing(1) == hpp::no_value && failing(1) == hpp::no_value && calls == 4 && failing.size() == 0 );
+    }
+
+    // The least recently used entry is evicted, lookups refresh recency
+    void eviction_order()
+    {
+        std::vector<int> computed;
+        hpp::memoized<int(int), 2> square( [&computed]( int value ){ computed.push_back( value ); return value * value; } );
+
+        square( 1 );
+        square( 2 );
+        square( 1 );
+        square( 3 );
+        assert( square.size() == 2 );
+
+        square( 1 );
+        square( 2 );
+        assert( ( computed == std::vector<int>{ 1, 2, 3, 2 } ) );
+    }
+
+    // Compares the cache with a reference LRU list over many keys, exercising probing and backward shift deletion
+    void eviction_matches_reference_model()
+    {
+        constexpr std::size_t capacity = 8;
+        int misses = 0;
+        hpp::memoized<int(int), capacity> identity( [&misses]( int value ){ ++misses; return value; } );
+        std::list<int> model;
+        unsigned state = 12345;
+
+        for( int i = 0; i < 5000; ++i )
+        {
+            state = state * 1103515245u + 12345u;
+            const auto key = static_cast<int>( (state >> 16) % 24 );
+            const auto hit = std::find( model.begin(), model.end(), key );
+            const auto expected_misses = misses + ( hit == model.end() ? 1 : 0 );
+
+            if( hit != model.end() )
+            {
+                model.erase( hit );
+            }
+            else if( model.size() == capacity )
+            {
+                model.pop_back();
+            }
+            model.push_front( key );
+
+            assert( *identity(key) == key && misses == expected_misses );
+        }
+    }
+
+    void expiry_and_reconnection_flush()
+    {
+        auto object = std::make_unique<receiver>();
+        int calls = 0;
+        hpp::memoized<int(int)> f( object->get_sentinel(), [&calls]( int value ){ ++calls; return value; } );
+
+        f( 1 );
+        f( 2 );
+        assert( f.size() == 2 );
+
+        object.reset();
+        assert( f(1) == hpp::no_value && f.size() == 0 && calls == 2 );
+
+        f.connect( [&calls]( int value ){ ++calls; return value * 10; } );
+        assert( *f(1) == 10 && calls == 3 );
+
+        f.connect( [&calls]( int value ){ ++calls; return value * 100; } );
+        assert( f.size() == 0 && *f(1) == 100 );
+
+        f.disconnect();
+        assert( f.size() == 0 && f(1) == hpp::no_value );
+    }
+
+    void concurrent_readers_see_correct_results()
+    {
+        std::atomic<int> calls { 0 };
+        hpp::concurrent_memoized<long(int), 4, 8> square( [&calls]( int value ){ calls.fetch_add( 1 ); return static_cast<long>( value ) * value; } );
+
+        std::vector<std::thread> threads;
+        for( int t = 0; t < 4; ++t )
+        {
+            threads.emplace_back( [&square, t]
+            {
+                for( int i = 0; i < 2000; ++i )
+                {
+                    const auto value = ( i * 7 + t ) % 50;
+                    assert( *square(value) == static_cast<long>( value ) * value );
+                    if( i % 500 == 0 )
+                    {
+                        square.flush();
+                    }
+                }
+            } );
+        }
+
+        for( auto& thread : threads )
+        {
+            thread.join();
+        }
+
+        assert( square.size() <= 4 * 8 );
+
+        auto object = std::make_unique<receiver>();
+        square.connect( object->get_sentinel(), []( int value ){ return static_cast<long>( value ); } );
+        assert( *square(3) == 3 );
+        object.reset();
+        assert( square(3) == hpp::no_value && square.size() == 0 );
+    }
+}
+
+int main()
+{
+    results_are_cached();
+    eviction_order();
+    eviction_matches_reference_model();
+    expiry_and_reconnection_flush();
+    concurrent_readers_see_correct_results();
+}
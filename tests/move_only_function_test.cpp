@@ -0,0 +1,97 @@
+// Checks of move_only_function storage and moves, run by ctest
+
+#include "function.hpp"
+
+#include <array>
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+    static_assert( !std::is_copy_constructible<hpp::move_only_function<void()>>::value, "move_only_function must not be copyable" );
+    static_assert( !std::is_copy_assignable<hpp::move_only_function<void()>>::value, "move_only_function must not be copyable" );
+    static_assert( std::is_nothrow_move_constructible<hpp::move_only_function<void()>>::value, "move_only_function moves must not throw" );
+    static_assert( std::is_nothrow_move_assignable<hpp::move_only_function<void()>>::value, "move_only_function moves must not throw" );
+
+    struct receiver : hpp::intrusive_lifetime_sentinel {};
+
+    // Counts moves and live instances
+    template<std::size_t PayloadSize, bool NothrowMove>
+    struct counted
+    {
+        static inline int live = 0;
+        static inline int moves = 0;
+
+        std::array<char, PayloadSize> payload {};
+        std::unique_ptr<int> value = std::make_unique<int>( 1 );
+
+        counted() { ++live; }
+        counted( counted&& other ) noexcept( NothrowMove ) : payload( other.payload ), value( std::move(other.value) ) { ++live; ++moves; }
+        ~counted() { --live; }
+
+        auto operator()() const -> int { return *value; }
+    };
+
+    void move_only_callables_are_stored()
+    {
+        auto owned = std::make_unique<int>( 5 );
+        hpp::move_only_function<int()> f( [owned = std::move(owned)]{ return *owned; } );
+        assert( *f() == 5 );
+
+        hpp::move_only_function<int(std::unique_ptr<int>)> take( []( std::unique_ptr<int> value ){ return *value; } );
+        assert( *take(std::make_unique<int>(6)) == 6 );
+    }
+
+    // Small callables move in place, large ones and those whose move may throw are moved by pointer
+    template<typename Callable>
+    void check_moves( int moves_per_function_move )
+    {
+        {
+            hpp::move_only_function<int()> f( Callable{} );
+            assert( Callable::live == 1 );
+
+            Callable::moves = 0;
+            hpp::move_only_function<int()> moved( std::move(f) );
+            assert( Callable::moves == moves_per_function_move && Callable::live == 1 && *moved() == 1 );
+            assert( f.empty() );
+
+            hpp::move_only_function<int()> assigned;
+            assigned = std::move( moved );
+            assert( Callable::moves == 2 * moves_per_function_move && Callable::live == 1 && *assigned() == 1 );
+
+            // Self move assignment keeps the callable
+            auto& self = assigned;
+            assigned = std::move( self );
+            assert( Callable::live == 1 && *assigned() == 1 );
+
+            // Assigning over a connected function destroys its callable
+            hpp::move_only_function<int()> other( Callable{} );
+            assert( Callable::live == 2 );
+            other = std::move( assigned );
+            assert( Callable::live == 1 && *other() == 1 );
+        }
+        assert( Callable::live == 0 );
+    }
+
+    void expired_functions_are_not_called()
+    {
+        auto object = std::make_unique<receiver>();
+        hpp::move_only_function<int()> f( object->get_sentinel(), [owned = std::make_unique<int>(3)]{ return *owned; } );
+        auto moved = std::move( f );
+        assert( *moved() == 3 );
+
+        object.reset();
+        assert( moved() == hpp::no_value && moved.expired() );
+    }
+}
+
+int main()
+{
+    move_only_callables_are_stored();
+    check_moves<counted<1, true>>( 1 );
+    check_moves<counted<64, true>>( 0 );
+    check_moves<counted<1, false>>( 0 );
+    expired_functions_are_not_called();
+}
@@ -0,0 +1,184 @@
+// Checks of overload_set and shared_overload_set resolution and argument passing, run by ctest
+
+#include "function.hpp"
+
+#include <cassert>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+    struct tracked
+    {
+        static inline int copies = 0;
+
+        tracked() = default;
+        tracked( const tracked& ) { ++copies; }
+        tracked( tracked&& ) noexcept = default;
+        auto operator=( const tracked& ) -> tracked& = default;
+        auto operator=( tracked&& ) noexcept -> tracked& = default;
+    };
+
+    // Records whether the callable received an rvalue
+    struct receiver
+    {
+        bool* rvalue;
+
+        template<typename T>
+        void operator()( T&& ) const
+        {
+            *rvalue = !std::is_lvalue_reference<T>::value;
+        }
+    };
+
+    template<template<typename...> class Set>
+    void by_value_signatures_copy_lvalues_once()
+    {
+        bool rvalue = false;
+        Set<void(tracked), void(std::string)> set( receiver{ &rvalue } );
+        tracked value;
+        const tracked constant;
+
+        tracked::copies = 0;
+        set( value );
+        assert( tracked::copies == 1 );
+
+        tracked::copies = 0;
+        set( constant );
+        assert( tracked::copies == 1 );
+
+        tracked::copies = 0;
+        set( tracked{} );
+        assert( tracked::copies == 0 );
+
+        int number = 1;
+        const int constant_number = 2;
+        Set<void(int), void(std::string)> numbers( receiver{ &rvalue } );
+        numbers( number );
+        numbers( constant_number );
+        numbers( 3 );
+    }
+
+    template<template<typename...> class Set>
+    void const_reference_signatures_do_not_copy()
+    {
+        bool rvalue = true;
+        Set<void(const tracked&), void(int)> set( receiver{ &rvalue } );
+        tracked value;
+        const tracked constant;
+
+        tracked::copies = 0;
+        set( value );
+        set( constant );
+        set( tracked{} );
+        assert( tracked::copies == 0 && !rvalue );
+    }
+
+    template<template<typename...> class Set>
+    void rvalue_reference_signatures_receive_rvalues()
+    {
+        bool rvalue = false;
+        Set<void(tracked&&), void(int)> set( receiver{ &rvalue } );
+
+        tracked::copies = 0;
+        set( tracked{} );
+        assert( tracked::copies == 0 && rvalue );
+
+        tracked value;
+        set( std::move(value) );
+        assert( tracked::copies == 0 && rvalue );
+    }
+
+    // Exact matches win over conversions, as in normal overload resolution
+    template<template<typename...> class Set>
+    void best_match_is_selected()
+    {
+        int selected = 0;
+        Set<void(int), void(double), void(const std::string&)> set( [&]( auto&& value )
+        {
+            using type = typename std::decay<decltype(value)>::type;
+            selected = std::is_same<type, int>::value ? 1 : std::is_same<type, double>::value ? 2 : 3;
+        } );
+
+        set( 1 );
+        assert( selected == 1 );
+        set( 1.0 );
+        assert( selected == 2 );
+        set( 1.0f );
+        assert( selected == 2 );
+        set( "text" );
+        assert( selected == 3 );
+
+        Set<int(int), double(int)> returning( []( int value ){ return value; } );
+        assert( *returning.template call<int>(4) == 4 && *returning.template call<double>(4) == 4.0 );
+    }
+
+    // Callable counting its live instances
+    struct counted
+    {
+        static inline int live = 0;
+
+        counted() { ++live; }
+        counted( const counted& ) { ++live; }
+        counted( counted&& ) noexcept { ++live; }
+        ~counted() { --live; }
+
+        template<typename T>
+        void operator()( T&& ) const {}
+    };
+
+    // Connecting stores one copy of the callable whatever the signature count, and copies it once from lvalues
+    template<template<typename...> class Set>
+    void callable_is_stored_once()
+    {
+        {
+            Set<void(int), void(double), void(const std::string&)> set( counted{} );
+            assert( counted::live == 1 );
+
+            const counted callable;
+            set.connect( callable );
+            assert( counted::live == 2 );
+
+            set( 1 );
+            set( 1.0 );
+            set( "text" );
+        }
+        assert( counted::live == 0 );
+    }
+
+    struct lifetime : hpp::intrusive_lifetime_sentinel {};
+
+    template<template<typename...> class Set>
+    void expired_sets_are_not_called()
+    {
+        auto object = std::make_unique<lifetime>();
+        int calls = 0;
+        Set<void(int), int(double)> set( object->get_sentinel(), [&calls]( auto value ){ ++calls; return static_cast<int>( value ); } );
+
+        set( 1 );
+        assert( *set.template call<int>(2.0) == 2 && calls == 2 );
+
+        object.reset();
+        set( 1 );
+        assert( set.template call<int>(2.0) == hpp::no_value && calls == 2 );
+    }
+
+    template<template<typename...> class Set>
+    void check_set()
+    {
+        callable_is_stored_once<Set>();
+        expired_sets_are_not_called<Set>();
+        by_value_signatures_copy_lvalues_once<Set>();
+        const_reference_signatures_do_not_copy<Set>();
+        rvalue_reference_signatures_receive_rvalues<Set>();
+        best_match_is_selected<Set>();
+    }
+}
+
+int main()
+{
+    check_set<hpp::overload_set>();
+    check_set<hpp::shared_overload_set>();
+}
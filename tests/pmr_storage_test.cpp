@@ -0,0 +1,139 @@
+// Checks of pmr_storage and signal memory resources, run by ctest
+
+#include "signal.hpp"
+
+#include <array>
+#include <cassert>
+#include <memory_resource>
+#include <utility>
+
+namespace
+{
+    // Counts the allocations it forwards to the default resource
+    class counting_resource : public std::pmr::memory_resource
+    {
+        auto do_allocate( std::size_t bytes, std::size_t alignment ) -> void* override
+        {
+            ++allocations;
+            ++live;
+            return std::pmr::new_delete_resource()->allocate( bytes, alignment );
+        }
+
+        void do_deallocate( void* memory, std::size_t bytes, std::size_t alignment ) override
+        {
+            --live;
+            std::pmr::new_delete_resource()->deallocate( memory, bytes, alignment );
+        }
+
+        auto do_is_equal( const std::pmr::memory_resource& other ) const noexcept -> bool override
+        {
+            return this == &other;
+        }
+
+    public:
+
+        int allocations = 0;
+        int live = 0;
+    };
+
+    using pmr_function = hpp::function<int(), hpp::pmr_storage<>>;
+
+    // Capture too large for the inline buffer
+    auto large_callable( int value )
+    {
+        std::array<int, 16> payload {};
+        payload[0] = value;
+        return [payload]{ return payload[0]; };
+    }
+
+    void large_captures_use_the_resource()
+    {
+        counting_resource resource;
+        {
+            pmr_function f;
+            f.set_memory_resource( &resource );
+
+            f.connect( []{ return 1; } );
+            assert( resource.allocations == 0 && *f() == 1 );
+
+            f.connect( large_callable(2) );
+            assert( resource.allocations == 1 && resource.live == 1 && *f() == 2 );
+
+            // Reconnecting keeps the resource
+            f.connect( large_callable(3) );
+            assert( resource.allocations == 2 && resource.live == 1 && *f() == 3 );
+            assert( f.get_memory_resource() == &resource );
+        }
+        assert( resource.live == 0 );
+    }
+
+    void copies_use_the_default_resource()
+    {
+        counting_resource resource;
+        pmr_function f;
+        f.set_memory_resource( &resource );
+        f.connect( large_callable(4) );
+
+        const pmr_function copy( f );
+        assert( resource.allocations == 1 && *copy() == 4 );
+        assert( copy.get_memory_resource() == std::pmr::get_default_resource() );
+    }
+
+    // Moving between functions on different resources copies the callable into the target's resource
+    void moves_respect_the_target_resource()
+    {
+        counting_resource source_resource;
+        counting_resource target_resource;
+        {
+            pmr_function source;
+            source.set_memory_resource( &source_resource );
+            source.connect( large_callable(5) );
+
+            pmr_function target;
+            target.set_memory_resource( &target_resource );
+            target = std::move( source );
+
+            assert( target.get_memory_resource() == &target_resource );
+            assert( target_resource.live == 1 && *target() == 5 );
+        }
+        assert( source_resource.live == 0 && target_resource.live == 0 );
+    }
+
+    void set_memory_resource_moves_the_callable()
+    {
+        counting_resource first;
+        counting_resource second;
+        {
+            pmr_function f;
+            f.set_memory_resource( &first );
+            f.connect( large_callable(6) );
+
+            f.set_memory_resource( &second );
+            assert( first.live == 0 && second.live == 1 && *f() == 6 );
+        }
+        assert( second.live == 0 );
+    }
+
+    void signals_allocate_from_their_resource()
+    {
+        counting_resource resource;
+        {
+            hpp::signal<int(), hpp::pmr_storage<>, hpp::default_policy, hpp::sum<int>> signal( &resource );
+            signal.connect( large_callable(1) );
+            signal.connect( large_callable(2) );
+            signal.connect( []{ return 3; } );
+
+            assert( resource.allocations > 0 && signal() == 6 );
+        }
+        assert( resource.live == 0 );
+    }
+}
+
+int main()
+{
+    large_captures_use_the_resource();
+    copies_use_the_default_resource();
+    moves_respect_the_target_resource();
+    set_memory_resource_moves_the_callable();
+    signals_allocate_from_their_resource();
+}
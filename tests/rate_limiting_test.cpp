@@ -0,0 +1,146 @@
+// Checks of the throttled, debounced and coalescing adaptors, run by ctest
+
+#include "adaptors.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    // Clock advanced by the tests
+    struct test_clock
+    {
+        using duration = std::chrono::milliseconds;
+        using rep = duration::rep;
+        using period = duration::period;
+        using time_point = std::chrono::time_point<test_clock, duration>;
+        static constexpr bool is_steady = true;
+
+        static inline time_point current {};
+
+        static auto now() -> time_point
+        {
+            return current;
+        }
+
+        static auto at( rep milliseconds ) -> time_point
+        {
+            return current = time_point( duration(milliseconds) );
+        }
+    };
+
+    struct receiver : hpp::intrusive_lifetime_sentinel {};
+
+    using std::chrono::milliseconds;
+
+    // The interval is closed at its end: a call or poll exactly one interval after the last call goes through
+    void throttle_window_boundaries()
+    {
+        std::vector<int> calls;
+        hpp::throttled<void(int), test_clock> f( milliseconds(10), [&calls]( int value ){ calls.push_back( value ); } );
+
+        test_clock::at( 0 );
+        f( 1 );
+        assert( ( calls == std::vector<int>{ 1 } ) && !f.pending() );
+
+        test_clock::at( 5 );
+        f( 2 );
+        test_clock::at( 9 );
+        f( 3 );
+        assert( calls.size() == 1 && f.pending() );
+        assert( !f.poll(test_clock::at(9)) );
+
+        // The pending call carries the latest arguments and fires at the boundary
+        assert( f.poll(test_clock::at(10)) );
+        assert( ( calls == std::vector<int>{ 1, 3 } ) && !f.poll(test_clock::at(10)) );
+
+        // The fired call opened a new interval
+        test_clock::at( 19 );
+        f( 4 );
+        assert( calls.size() == 2 && f.pending() );
+
+        // A call at the boundary goes straight through and replaces the pending one
+        test_clock::at( 20 );
+        f( 5 );
+        assert( ( calls == std::vector<int>{ 1, 3, 5 } ) && !f.pending() );
+    }
+
+    void debounce_restarts_the_delay()
+    {
+        std::vector<int> calls;
+        hpp::debounced<void(int), test_clock> f( milliseconds(10), [&calls]( int value ){ calls.push_back( value ); } );
+
+        test_clock::at( 0 );
+        f( 1 );
+        test_clock::at( 5 );
+        f( 2 );
+
+        assert( !f.poll(test_clock::at(10)) && !f.poll(test_clock::at(14)) );
+        assert( f.poll(test_clock::at(15)) );
+        assert( ( calls == std::vector<int>{ 2 } ) && !f.pending() && !f.poll(test_clock::at(30)) );
+    }
+
+    void coalescing_calls_once_per_tick()
+    {
+        std::vector<int> calls;
+        hpp::coalescing<void(int)> f( [&calls]( int value ){ calls.push_back( value ); } );
+
+        assert( !f.tick() );
+        f( 1 );
+        f( 2 );
+        f( 3 );
+        assert( f.tick() && !f.tick() );
+        assert( ( calls == std::vector<int>{ 3 } ) );
+
+        f( 4 );
+        f.cancel();
+        assert( !f.tick() );
+
+        f( 5 );
+        f.connect( [&calls]( int value ){ calls.push_back( -value ); } );
+        assert( !f.pending() && !f.tick() );
+    }
+
+    // The callee may defer a new call while the pending one fires
+    void callee_may_defer_again()
+    {
+        int fired = 0;
+        hpp::coalescing<void(int)> f;
+        f.connect( [&]( int remaining )
+        {
+            ++fired;
+            if( remaining > 0 )
+            {
+                f( remaining - 1 );
+            }
+        } );
+
+        f( 2 );
+        while( f.tick() ) {}
+        assert( fired == 3 );
+    }
+
+    // Pending calls of an expired function are dropped when they fire
+    void expired_functions_are_not_called()
+    {
+        auto object = std::make_unique<receiver>();
+        int calls = 0;
+        hpp::debounced<void(), test_clock> f( milliseconds(1), object->get_sentinel(), [&calls]{ ++calls; } );
+
+        test_clock::at( 0 );
+        f();
+        object.reset();
+        assert( f.poll(test_clock::at(1)) && calls == 0 && !f.valid() );
+    }
+}
+
+int main()
+{
+    throttle_window_boundaries();
+    debounce_restarts_the_delay();
+    coalescing_calls_once_per_tick();
+    callee_may_defer_again();
+    expired_functions_are_not_called();
+}
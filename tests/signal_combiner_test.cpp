@@ -0,0 +1,201 @@
+// Checks of signal result combiners and parallel emission, run by ctest
+
+#include "signal.hpp"
+
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Fixed size thread pool executor
+    class thread_pool
+    {
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::deque<std::function<void()>> tasks_;
+        std::vector<std::thread> threads_;
+        bool stopping_ = false;
+
+    public:
+
+        explicit thread_pool( std::size_t size )
+        {
+            for( std::size_t i = 0; i < size; ++i )
+            {
+                threads_.emplace_back( [this]
+                {
+                    for( ;; )
+                    {
+                        std::function<void()> task;
+                        {
+                            std::unique_lock<std::mutex> lock( mutex_ );
+                            ready_.wait( lock, [this]{ return stopping_ || !tasks_.empty(); } );
+                            if( tasks_.empty() )
+                            {
+                                return;
+                            }
+                            task = std::move( tasks_.front() );
+                            tasks_.pop_front();
+                        }
+                        task();
+                    }
+                } );
+            }
+        }
+
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock( mutex_ );
+                stopping_ = true;
+            }
+            ready_.notify_all();
+            for( auto& thread : threads_ )
+            {
+                thread.join();
+            }
+        }
+
+        auto running_in_this_thread() const -> bool
+        {
+            for( const auto& thread : threads_ )
+            {
+                if( thread.get_id() == std::this_thread::get_id() )
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template<typename Task>
+        void post( Task&& task )
+        {
+            {
+                std::lock_guard<std::mutex> lock( mutex_ );
+                tasks_.emplace_back( std::forward<Task>(task) );
+            }
+            ready_.notify_one();
+        }
+    };
+
+    template<typename Combiner>
+    using int_signal = hpp::signal<int(int), hpp::default_storage, hpp::default_policy, Combiner>;
+
+    void combiners_reduce_in_slot_order()
+    {
+        int_signal<hpp::collect<int>> collected;
+        int_signal<hpp::sum<int>> summed;
+        int_signal<hpp::minimum<int>> smallest;
+
+        for( int offset : { 3, 1, 2, 1 } )
+        {
+            collected.connect( [offset]( int value ){ return value + offset; } );
+            summed.connect( [offset]( int value ){ return value + offset; } );
+            smallest.connect( [offset]( int value ){ return value + offset; } );
+        }
+
+        // Slots without a value are not combined
+        collected.connect( []( int ) -> int { throw hpp::function_exception(); } );
+
+        assert( ( collected(10) == std::vector<int>{ 13, 11, 12, 11 } ) );
+        assert( summed(10) == 47 );
+        assert( *smallest(10) == 11 );
+    }
+
+    // first_valid stops the emission at the first value, later slots do not run
+    void combiner_stops_early()
+    {
+        int_signal<hpp::first_valid<int>> signal;
+        int calls = 0;
+
+        signal.connect( [&calls]( int ) -> int { ++calls; throw hpp::function_exception(); } );
+        signal.connect( [&calls]( int value ){ ++calls; return value; } );
+        signal.connect( [&calls]( int value ){ ++calls; return value * 2; } );
+
+        assert( *signal(5) == 5 && calls == 2 );
+
+        // An emission stopped early still compacts disconnected slots away
+        hpp::signal<int(int)> plain;
+        auto removed = plain.connect( []( int value ){ return value; } );
+        plain.connect( []( int value ){ return value; } );
+        removed.disconnect();
+        assert( *plain.combine( hpp::first_valid<int>{}, 1 ) == 1 && plain.size() == 1 );
+    }
+
+    // Partial results of the chunks are merged in slot order
+    void parallel_partials_are_merged()
+    {
+        thread_pool pool( 3 );
+        int_signal<hpp::collect<int>> collected;
+        int_signal<hpp::sum<int>> summed;
+
+        std::vector<int> expected;
+        for( int i = 0; i < 10; ++i )
+        {
+            collected.connect( [i]( int value ){ return value + i; } );
+            summed.connect( [i]( int value ){ return value + i; } );
+            expected.push_back( 100 + i );
+        }
+
+        assert( collected.emit_parallel(pool, 3, 100) == expected );
+        assert( summed.emit_parallel(pool, 2, 100) == 1045 );
+
+        // The earliest value wins even when a later chunk finishes first
+        int_signal<hpp::first_valid<int>> first;
+        for( int i = 0; i < 6; ++i )
+        {
+            first.connect( [i]( int ) -> int
+            {
+                if( i < 3 )
+                {
+                    throw hpp::function_exception();
+                }
+                return i;
+            } );
+        }
+        assert( *first.emit_parallel(pool, 2, 0) == 3 );
+    }
+
+    void parallel_errors_are_rethrown()
+    {
+        thread_pool pool( 2 );
+        int_signal<hpp::sum<int>> signal;
+        for( int i = 0; i < 8; ++i )
+        {
+            signal.connect( [i]( int value ) -> int
+            {
+                if( i == 5 )
+                {
+                    throw std::runtime_error( "slot" );
+                }
+                return value;
+            } );
+        }
+
+        bool threw = false;
+        try
+        {
+            signal.emit_parallel( pool, 2, 1 );
+        }
+        catch( const std::runtime_error& )
+        {
+            threw = true;
+        }
+        assert( threw );
+    }
+}
+
+int main()
+{
+    combiners_reduce_in_slot_order();
+    combiner_stops_early();
+    parallel_partials_are_merged();
+    parallel_errors_are_rethrown();
+}
@@ -0,0 +1,113 @@
+// Checks of signal connections, run by ctest
+
+#include "signal.hpp"
+
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // Connections keep addressing their slot after compaction moved it
+    void connections_follow_compacted_slots()
+    {
+        hpp::signal<void()> signal;
+        std::vector<int> calls;
+        std::vector<hpp::connection> connections;
+
+        for( int i = 0; i < 4; ++i )
+        {
+            connections.push_back( signal.connect( [&calls, i]{ calls.push_back( i ); } ) );
+        }
+
+        connections[0].disconnect();
+        connections[2].disconnect();
+        signal();
+        assert( ( calls == std::vector<int>{ 1, 3 } ) );
+
+        assert( !connections[0].connected() && connections[1].connected() && connections[3].connected() );
+        connections[3].disconnect();
+        signal();
+        assert( ( calls == std::vector<int>{ 1, 3, 1 } ) );
+        assert( signal.size() == 1 );
+    }
+
+    // A released slot handle may be reused, the stale connection does not reach the new slot
+    void stale_connections_do_not_reach_reused_slots()
+    {
+        hpp::signal<void()> signal;
+        int calls = 0;
+
+        auto stale = signal.connect( [&calls]{ ++calls; } );
+        auto copy = stale;
+        stale.disconnect();
+        signal();
+
+        auto fresh = signal.connect( [&calls]{ calls += 10; } );
+        assert( !copy.connected() && fresh.connected() );
+
+        copy.disconnect();
+        signal();
+        assert( calls == 10 && fresh.connected() );
+    }
+
+    // Slots connected during an emission can be disconnected before and after they are merged
+    void pending_slots_are_addressable()
+    {
+        hpp::signal<void()> signal;
+        int calls = 0;
+        hpp::connection first;
+        hpp::connection second;
+
+        auto connector = signal.connect( [&]
+        {
+            first = signal.connect( [&calls]{ ++calls; } );
+            second = signal.connect( [&calls]{ ++calls; } );
+            assert( first.connected() && second.connected() );
+            first.disconnect();
+        } );
+
+        signal();
+        connector.disconnect();
+        assert( !first.connected() && second.connected() );
+
+        signal();
+        assert( calls == 1 );
+        second.disconnect();
+        assert( signal.empty() );
+    }
+
+    // A slot throwing out of the emission leaves the slots it did not reach addressable
+    void interrupted_compaction_keeps_the_tail()
+    {
+        hpp::signal<void()> signal;
+        int calls = 0;
+        auto removed = signal.connect( []{} );
+        auto thrower = signal.connect( []{ throw std::runtime_error( "slot" ); } );
+        auto tail = signal.connect( [&calls]{ ++calls; } );
+
+        removed.disconnect();
+        try
+        {
+            signal();
+            assert( false );
+        }
+        catch( const std::runtime_error& ) {}
+
+        assert( calls == 0 && thrower.connected() && tail.connected() );
+        thrower.disconnect();
+        signal();
+        assert( calls == 1 && signal.size() == 1 );
+
+        tail.disconnect();
+        assert( signal.empty() );
+    }
+}
+
+int main()
+{
+    connections_follow_compacted_slots();
+    stale_connections_do_not_reach_reused_slots();
+    pending_slots_are_addressable();
+    interrupted_compaction_keeps_the_tail();
+}
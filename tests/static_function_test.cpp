@@ -0,0 +1,108 @@
+// Checks of static_function, run by ctest
+
+#include "function.hpp"
+
+#include <cassert>
+#include <type_traits>
+
+namespace
+{
+    int last = 0;
+
+    auto twice( int value ) -> int
+    {
+        return value * 2;
+    }
+
+    auto negate( int value ) noexcept -> int
+    {
+        return -value;
+    }
+
+    void record( int value )
+    {
+        last = value;
+    }
+
+    auto failing( int value ) -> int
+    {
+        if( value < 0 )
+        {
+            throw hpp::function_exception();
+        }
+        return value;
+    }
+
+    auto passing_through() -> int
+    {
+        throw hpp::function_exception( true );
+    }
+
+    static_assert( std::is_empty<hpp::static_function<&twice>>::value, "static_function must be an empty object" );
+    static_assert( std::is_same<decltype(hpp::static_function<&twice>{}(1)), hpp::optional<int>>::value, "static_function must return optional results" );
+    static_assert( noexcept(hpp::static_function<&twice, hpp::nothrow_policy>{}(1)), "nothrow static_function calls must be noexcept" );
+
+    static_assert( hpp::static_function<&twice>{}.valid() && !hpp::static_function<&twice>{}.expired(), "static_function is always valid" );
+    static_assert( ( hpp::static_function<&twice>{}.disconnect(), true ), "disconnect must be usable in constant expressions" );
+
+    // Written against the hpp::function interface
+    template<typename Function>
+    auto call_once( Function& f, int value ) -> hpp::optional<int>
+    {
+        if( !f.valid() )
+        {
+            return hpp::no_value;
+        }
+
+        auto result = f( value );
+        f.disconnect();
+        return result;
+    }
+
+    void results_match_function()
+    {
+        const hpp::static_function<&twice> f;
+        const hpp::static_function<&negate> g;
+        assert( *f(2) == 4 && *g(3) == -3 && f && !f.empty() );
+
+        const hpp::static_function<&record> h;
+        h( 5 );
+        assert( last == 5 );
+    }
+
+    void function_exceptions_are_translated()
+    {
+        const hpp::static_function<&failing> f;
+        assert( *f(1) == 1 && f(-1) == hpp::no_value );
+
+        // Passthrough exceptions reach the caller
+        const hpp::static_function<&passing_through> g;
+        bool threw = false;
+        try
+        {
+            g();
+        }
+        catch( const hpp::function_exception& e )
+        {
+            threw = e.is_passthrough();
+        }
+        assert( threw );
+    }
+
+    // disconnect is a no-op, so generic code sees the same results before and after it
+    void generic_code_accepts_static_functions()
+    {
+        hpp::static_function<&twice> fixed;
+        hpp::function<int(int)> dynamic( &twice );
+
+        assert( *call_once(fixed, 3) == 6 && *call_once(fixed, 4) == 8 && fixed.valid() );
+        assert( *call_once(dynamic, 3) == 6 && call_once(dynamic, 4) == hpp::no_value );
+    }
+}
+
+int main()
+{
+    results_match_function();
+    function_exceptions_are_translated();
+    generic_code_accepts_static_functions();
+}
@@ -0,0 +1,40 @@
+// Checks of synchronized_lifetime_sentinel, run by ctest
+
+#include "function.hpp"
+
+#include <cassert>
+#include <stdexcept>
+
+namespace
+{
+    // Retiring while pinned could deadlock against another retiring thread, so it is rejected
+    void retire_inside_critical_section_throws()
+    {
+        hpp::synchronized_lifetime_sentinel sentinel;
+        hpp::function<void()> f;
+        bool threw = false;
+
+        f.connect( sentinel.get_sentinel(), [&]
+        {
+            try
+            {
+                sentinel.retire();
+            }
+            catch( const std::logic_error& )
+            {
+                threw = true;
+            }
+        } );
+
+        f();
+        assert( threw && f.valid() );
+
+        sentinel.retire();
+        assert( !f.valid() );
+    }
+}
+
+int main()
+{
+    retire_inside_critical_section_throws();
+}
@@ -0,0 +1,89 @@
+// Checks of the traced call policy, run by ctest
+
+#include "function.hpp"
+#include "signal.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+namespace
+{
+    struct tag
+    {
+        static constexpr const char* name = "traced_test";
+    };
+
+    using policy = hpp::traced<tag>;
+
+    // Spans carry the address of the function that was called, and the JSON export carries it in args
+    void spans_carry_the_function()
+    {
+        auto& recorder = hpp::trace_recorder::instance();
+        recorder.clear();
+
+        hpp::function<void(), hpp::default_storage, policy> first( []{} );
+        hpp::function<void(), hpp::default_storage, policy> second( []{} );
+        first();
+        second();
+
+        const auto events = recorder.events();
+        assert( events.size() == 2 );
+        assert( events[0].function == &first && events[1].function == &second );
+
+        char address[32];
+        std::snprintf( address, sizeof(address), "\"function\":\"%p\"", static_cast<const void*>(&first) );
+        assert( recorder.chrome_trace_json().find(address) != std::string::npos );
+    }
+
+    void emissions_carry_the_signal()
+    {
+        auto& recorder = hpp::trace_recorder::instance();
+        recorder.clear();
+
+        hpp::signal<void(), hpp::default_storage, policy> signal;
+        signal.connect( []{} );
+        signal();
+
+        std::size_t emissions = 0;
+        for( const auto& event : recorder.events() )
+        {
+            if( std::string( event.category ) == "emit" )
+            {
+                assert( event.function == &signal );
+                ++emissions;
+            }
+        }
+        assert( emissions == 1 );
+    }
+
+    // Threads that run one after another share a single buffer, each span keeps the thread that recorded it
+    void buffers_of_exited_threads_are_reused()
+    {
+        auto& recorder = hpp::trace_recorder::instance();
+        recorder.clear();
+
+        const hpp::_trace_buffer* buffers[2] = {};
+        for( auto* buffer : { &buffers[0], &buffers[1] } )
+        {
+            std::thread( [buffer]
+            {
+                hpp::function<void(), hpp::default_storage, policy> f( []{} );
+                f();
+                *buffer = hpp::trace_recorder::local();
+            } ).join();
+        }
+        assert( buffers[0] != nullptr && buffers[0] == buffers[1] );
+
+        const auto events = recorder.events();
+        assert( events.size() == 2 && events[0].thread != events[1].thread );
+    }
+}
+
+int main()
+{
+    spans_carry_the_function();
+    emissions_carry_the_signal();
+    buffers_of_exited_threads_are_reused();
+}